@@ -0,0 +1,131 @@
+#ifndef CHANGE_TRACKING_BENCHMARK_H
+#define CHANGE_TRACKING_BENCHMARK_H
+
+#include "../src/engine/ecs/Registry.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Measures what change tracking costs writers and saves readers. Each tick
+// a share of the entities is written twice, once through plain TryGet and
+// once through Patch, and a reader then syncs the changes: with tracking by
+// asking for changes since its last tick, without it by comparing the whole
+// pool against its own copy.
+namespace ChangeTrackingBenchmark {
+
+struct Body {
+	float x = 0.0f, y = 0.0f;
+	float vx = 1.0f, vy = 1.0f;
+};
+
+struct Result {
+	double untrackedWriteMs = 0.0;
+	double trackedWriteMs = 0.0;
+	double querySyncMs = 0.0;
+	double scanSyncMs = 0.0;
+	size_t writes = 0;
+	size_t synced = 0;
+	size_t scanned = 0;
+	size_t logSize = 0;
+};
+
+inline Result Run(int entityCount, int ticks, double writeShare) {
+	using Clock = std::chrono::steady_clock;
+	Result result;
+	std::mt19937 rng(1234);
+
+	Registry registry;
+	std::vector<EntityId> entities;
+	for (int i = 0; i < entityCount; i++) {
+		EntityId entity = registry.Create();
+		registry.Add<Body>(entity);
+		entities.push_back(entity);
+	}
+	ComponentPool<Body> &pool = registry.Pool<Body>();
+
+	// The reader's copy, kept by entity slot
+	std::vector<Body> mirror(entityCount);
+	uint64_t syncedTick = 0;
+
+	std::uniform_int_distribution<int> pick(0, entityCount - 1);
+	int writesPerTick = static_cast<int>(entityCount * writeShare);
+	std::vector<EntityId> targets(writesPerTick);
+	for (int tick = 0; tick < ticks; tick++) {
+		for (EntityId &target : targets) {
+			target = entities[pick(rng)];
+		}
+
+		// Two writes per target, as a system reading then adjusting would
+		Clock::time_point start = Clock::now();
+		for (int pass = 0; pass < 2; pass++) {
+			for (EntityId target : targets) {
+				Body *body = pool.TryGet(target);
+				body->x += body->vx;
+				body->y += body->vy;
+			}
+		}
+		Clock::time_point untracked = Clock::now();
+		for (int pass = 0; pass < 2; pass++) {
+			for (EntityId target : targets) {
+				Body *body = pool.Patch(target);
+				body->x -= body->vx;
+				body->y -= body->vy;
+			}
+		}
+		Clock::time_point tracked = Clock::now();
+		// Leave this tick's changes visible to both readers
+		for (EntityId target : targets) {
+			pool.Patch(target)->vx += 1.0f;
+		}
+
+		Clock::time_point queryStart = Clock::now();
+		registry.ConsumeChanges<Body>(syncedTick, [&](EntityId entity, Body &body) {
+			mirror[EntityIndex(entity)] = body;
+			result.synced++;
+		});
+		Clock::time_point queried = Clock::now();
+
+		const std::vector<EntityId> &owners = pool.Entities();
+		std::vector<Body> &bodies = pool.Components();
+		for (size_t i = 0; i < owners.size(); i++) {
+			Body &copy = mirror[EntityIndex(owners[i])];
+			if (copy.x != bodies[i].x || copy.y != bodies[i].y || copy.vx != bodies[i].vx || copy.vy != bodies[i].vy) {
+				copy = bodies[i];
+			}
+			result.scanned++;
+		}
+		Clock::time_point scanned = Clock::now();
+
+		result.writes += targets.size() * 2;
+		result.untrackedWriteMs += std::chrono::duration<double, std::milli>(untracked - start).count();
+		result.trackedWriteMs += std::chrono::duration<double, std::milli>(tracked - untracked).count();
+		result.querySyncMs += std::chrono::duration<double, std::milli>(queried - queryStart).count();
+		result.scanSyncMs += std::chrono::duration<double, std::milli>(scanned - queried).count();
+	}
+	result.logSize = pool.GetChangeLogSize();
+	return result;
+}
+
+inline void PrintResult(const char *label, const Result &result, int ticks) {
+	double writes = static_cast<double>(result.writes);
+	printf("  %-12s writes %6.2f ns untracked %6.2f ns tracked  sync %7.3f ms query %7.3f ms scan  %8.0f synced/tick  "
+		   "log %zu\n",
+		   label, result.untrackedWriteMs * 1e6 / writes, result.trackedWriteMs * 1e6 / writes, result.querySyncMs / ticks,
+		   result.scanSyncMs / ticks, double(result.synced) / ticks, result.logSize);
+}
+
+// 100k entities, writing 1%, 10% and all of them per tick
+inline void RunAndPrint() {
+	const int entityCount = 100000, ticks = 120;
+
+	printf("Change tracking benchmark (%d entities, %d ticks)\n", entityCount, ticks);
+	PrintResult("1% written", Run(entityCount, ticks, 0.01), ticks);
+	PrintResult("10% written", Run(entityCount, ticks, 0.10), ticks);
+	PrintResult("all written", Run(entityCount, ticks, 1.0), ticks);
+}
+
+} // namespace ChangeTrackingBenchmark
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef CHUNK_MAP_BENCHMARK_H
+#define CHUNK_MAP_BENCHMARK_H
+
+#include "../src/engine/utils/ChunkMap.hpp"
+#include "../src/engine/utils/glm_hash.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+
+// Compares ChunkMap with std::unordered_map under the streaming pattern: a
+// view-sized window of chunks slides across the map, inserting the chunks
+// that enter it and erasing the ones that leave, and every chunk in the
+// window then looks up its eight neighbours.
+namespace ChunkMapBenchmark {
+
+struct Result {
+	double insertEraseMs = 0.0;
+	double lookupMs = 0.0;
+	size_t lookups = 0;
+	uintptr_t checksum = 0;
+};
+
+template <typename MapType, typename FindFn>
+Result Run(int windowWidth, int windowHeight, int steps, FindFn find) {
+	using Clock = std::chrono::steady_clock;
+	Result result;
+	MapType map;
+
+	auto value = [](int x, int y) {
+		uintptr_t bits = (static_cast<uintptr_t>(x) * 73856093u) ^ (static_cast<uintptr_t>(y) * 19349663u);
+		return reinterpret_cast<void *>(bits | 1);
+	};
+
+	for (int y = 0; y < windowHeight; y++) {
+		for (int x = 0; x < windowWidth; x++) {
+			map[glm::ivec2(x, y)] = value(x, y);
+		}
+	}
+
+	glm::ivec2 origin(0, 0);
+	for (int step = 0; step < steps; step++) {
+		// Pan diagonally, turning every 64 steps like a player exploring
+		glm::ivec2 move = (step / 64) % 2 == 0 ? glm::ivec2(1, 0) : glm::ivec2(0, 1);
+
+		Clock::time_point start = Clock::now();
+		if (move.x) {
+			for (int y = origin.y; y < origin.y + windowHeight; y++) {
+				map.erase(glm::ivec2(origin.x, y));
+				map[glm::ivec2(origin.x + windowWidth, y)] = value(origin.x + windowWidth, y);
+			}
+		} else {
+			for (int x = origin.x; x < origin.x + windowWidth; x++) {
+				map.erase(glm::ivec2(x, origin.y));
+				map[glm::ivec2(x, origin.y + windowHeight)] = value(x, origin.y + windowHeight);
+			}
+		}
+		origin += move;
+		Clock::time_point inserted = Clock::now();
+
+		for (int y = origin.y; y < origin.y + windowHeight; y++) {
+			for (int x = origin.x; x < origin.x + windowWidth; x++) {
+				for (int dy = -1; dy <= 1; dy++) {
+					for (int dx = -1; dx <= 1; dx++) {
+						result.checksum += reinterpret_cast<uintptr_t>(find(map, glm::ivec2(x + dx, y + dy)));
+						result.lookups++;
+					}
+				}
+			}
+		}
+		Clock::time_point looked = Clock::now();
+
+		result.insertEraseMs += std::chrono::duration<double, std::milli>(inserted - start).count();
+		result.lookupMs += std::chrono::duration<double, std::milli>(looked - inserted).count();
+	}
+	return result;
+}
+
+// Prints timings for a zoomed-out view (64x36 chunks) sliding 2048 chunks
+inline void RunAndPrint() {
+	const int width = 64, height = 36, steps = 2048;
+
+	Result flat = Run<ChunkMap<void *>>(width, height, steps, [](ChunkMap<void *> &map, const glm::ivec2 &key) {
+		void **found = map.Find(key);
+		return found ? *found : nullptr;
+	});
+	Result node = Run<std::unordered_map<glm::ivec2, void *>>(width, height, steps, [](std::unordered_map<glm::ivec2, void *> &map, const glm::ivec2 &key) {
+		auto it = map.find(key);
+		return it != map.end() ? it->second : nullptr;
+	});
+
+	printf("ChunkMap benchmark (%dx%d window, %d steps, %zu lookups)\n", width, height, steps, flat.lookups);
+	printf("  %-14s insert/erase %8.2f ms  lookup %8.2f ms (%.1f ns/lookup)\n", "ChunkMap",
+		   flat.insertEraseMs, flat.lookupMs, flat.lookupMs * 1e6 / flat.lookups);
+	printf("  %-14s insert/erase %8.2f ms  lookup %8.2f ms (%.1f ns/lookup)\n", "unordered_map",
+		   node.insertEraseMs, node.lookupMs, node.lookupMs * 1e6 / node.lookups);
+	if (flat.checksum != node.checksum) {
+		printf("  checksum mismatch: %zx vs %zx\n", static_cast<size_t>(flat.checksum), static_cast<size_t>(node.checksum));
+	}
+}
+
+} // namespace ChunkMapBenchmark
+
+#endif
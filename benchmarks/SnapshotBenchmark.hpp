@@ -0,0 +1,126 @@
+#ifndef SNAPSHOT_BENCHMARK_H
+#define SNAPSHOT_BENCHMARK_H
+
+#include "../src/game/components/Chunk.hpp"
+#include "../src/game/components/ChunkTiles.hpp"
+#include "../src/game/components/World.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <random>
+#include <vector>
+
+// Measures copy-on-write snapshots under a heavy edit load. Every frame takes
+// a snapshot and hands it to a reader thread, standing in for a background
+// saver, while the main thread keeps editing tiles. Reports the cost of a
+// snapshot, of the edits, and how many bytes were copied per edit.
+namespace SnapshotBenchmark {
+
+struct Result {
+	double snapshotMs = 0.0;
+	double editMs = 0.0;
+	size_t edits = 0;
+	size_t copies = 0;
+	size_t bytesCopied = 0;
+	bool consistent = true;
+};
+
+inline uint64_t Checksum(const WorldSnapshot &snapshot) {
+	uint64_t sum = 0;
+	snapshot.ForEachChunk([&](const glm::ivec2 &chunkCoord, const ChunkTiles &tiles) {
+		tiles.types.ForEach([&](size_t index, TILE_TYPE type) {
+			sum = sum * 31 + type + index + static_cast<uint64_t>(chunkCoord.x * 7 + chunkCoord.y);
+		});
+	});
+	return sum;
+}
+
+// Edits are clustered into square pastes of pasteSize tiles a side, which
+// is the usual shape of mass edits. A paste of 1 is fully scattered.
+inline Result Run(int worldChunks, int frames, int editsPerFrame, int pasteSize) {
+	using Clock = std::chrono::steady_clock;
+	Result result;
+	std::mt19937 rng(1234);
+
+	World world;
+	std::vector<Chunk *> chunks;
+	for (int y = 0; y < worldChunks; y++) {
+		for (int x = 0; x < worldChunks; x++) {
+			Chunk *chunk = new Chunk(nullptr, nullptr);
+			ChunkTiles tiles;
+			for (int i = 0; i < CHUNK_AREA; i++) {
+				tiles.SetType(i, static_cast<TILE_TYPE>(TILE_GRASS_1 + rng() % 4));
+			}
+			tiles.Compact();
+			chunk->tiles = tiles;
+			world.AddChunk(glm::ivec2(x, y), chunk);
+			chunks.push_back(chunk);
+		}
+	}
+
+	std::uniform_int_distribution<int> position(0, worldChunks * CHUNK_SIZE - pasteSize);
+	std::uniform_int_distribution<int> type(TILE_GRASS_1, TILE_GOLD_ORE);
+	for (int frame = 0; frame < frames; frame++) {
+		Clock::time_point start = Clock::now();
+		WorldSnapshot snapshot = world.Snapshot();
+		Clock::time_point snapped = Clock::now();
+
+		std::future<uint64_t> reader = std::async(std::launch::async, [&snapshot]() { return Checksum(snapshot); });
+
+		std::vector<size_t> copiesBefore;
+		for (Chunk *chunk : chunks) {
+			copiesBefore.push_back(chunk->tiles.GetCopyCount());
+		}
+
+		for (int edit = 0; edit < editsPerFrame; edit += pasteSize * pasteSize) {
+			glm::ivec2 corner(position(rng), position(rng));
+			TILE_TYPE paste = static_cast<TILE_TYPE>(type(rng));
+			for (int dy = 0; dy < pasteSize; dy++) {
+				for (int dx = 0; dx < pasteSize; dx++) {
+					world.SetTile(corner + glm::ivec2(dx, dy), paste);
+				}
+			}
+			result.edits += pasteSize * pasteSize;
+		}
+		Clock::time_point edited = Clock::now();
+
+		// The reader must have seen the frame's starting state throughout
+		uint64_t seen = reader.get();
+		result.consistent = result.consistent && seen == Checksum(snapshot);
+
+		for (size_t i = 0; i < chunks.size(); i++) {
+			size_t copies = chunks[i]->tiles.GetCopyCount() - copiesBefore[i];
+			result.copies += copies;
+			result.bytesCopied += copies * (sizeof(ChunkTiles) + chunks[i]->tiles->HeapBytes());
+		}
+		result.snapshotMs += std::chrono::duration<double, std::milli>(snapped - start).count();
+		result.editMs += std::chrono::duration<double, std::milli>(edited - snapped).count();
+	}
+
+	world.Clear();
+	for (Chunk *chunk : chunks) {
+		delete chunk;
+	}
+	return result;
+}
+
+inline void PrintResult(const char *label, const Result &result, int frames) {
+	printf("  %-22s snapshot %6.3f ms/frame  edits %7.3f ms/frame  %5.1f copies/frame  %7.1f bytes copied/edit%s\n",
+		   label, result.snapshotMs / frames, result.editMs / frames, double(result.copies) / frames,
+		   result.edits ? double(result.bytesCopied) / result.edits : 0.0, result.consistent ? "" : "  INCONSISTENT");
+}
+
+// 32x32 loaded chunks, 8192 tile edits per frame
+inline void RunAndPrint() {
+	const int worldChunks = 32, frames = 120, editsPerFrame = 8192;
+
+	printf("Snapshot benchmark (%d chunks, %d frames, %d edits/frame)\n", worldChunks * worldChunks, frames, editsPerFrame);
+	PrintResult("scattered edits", Run(worldChunks, frames, editsPerFrame, 1), frames);
+	PrintResult("16x16 pastes", Run(worldChunks, frames, editsPerFrame, 16), frames);
+	PrintResult("64x64 pastes", Run(worldChunks, frames, editsPerFrame, 64), frames);
+}
+
+} // namespace SnapshotBenchmark
+
+#endif
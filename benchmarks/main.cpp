@@ -0,0 +1,41 @@
+#include "ChangeTrackingBenchmark.hpp"
+#include "ChunkMapBenchmark.hpp"
+#include "SnapshotBenchmark.hpp"
+#include <cstdio>
+#include <cstring>
+
+// Runs the benchmarks named on the command line, or all of them. Kept out of
+// the game so none of them can stall a frame.
+struct Benchmark {
+	const char *name;
+	void (*run)();
+};
+
+static const Benchmark benchmarks[] = {
+	{"chunkmap", ChunkMapBenchmark::RunAndPrint},
+	{"snapshot", SnapshotBenchmark::RunAndPrint},
+	{"changes", ChangeTrackingBenchmark::RunAndPrint},
+};
+
+int main(int argc, char **argv) {
+	int ran = 0;
+	for (const Benchmark &benchmark : benchmarks) {
+		bool selected = argc < 2;
+		for (int i = 1; i < argc; i++) {
+			selected |= std::strcmp(argv[i], benchmark.name) == 0;
+		}
+		if (!selected) continue;
+		benchmark.run();
+		ran++;
+	}
+
+	if (ran == 0) {
+		printf("Usage: %s [benchmark...]\nBenchmarks:", argv[0]);
+		for (const Benchmark &benchmark : benchmarks) {
+			printf(" %s", benchmark.name);
+		}
+		printf("\n");
+		return 1;
+	}
+	return 0;
+}
@@ -1,7 +1,10 @@
 #include "ResourceManager.hpp"
+#include "async/Scheduler.hpp"
 #include "utils/Font.h"
+#include "utils/GLState.hpp"
 #include "utils/Shader.hpp"
 #include "utils/Texture.hpp"
+#include <algorithm>
 #include <map>
 #define STB_IMAGE_IMPLEMENTATION
 #include "../include/stb_image.h"
@@ -11,6 +14,7 @@
 
 // Instantiate static variables
 std::map<std::string, Texture2D> ResourceManager::Textures;
+std::map<std::string, TextureArray> ResourceManager::TextureArrays;
 std::map<std::string, Shader> ResourceManager::Shaders;
 std::map<std::string, Font> ResourceManager::Fonts;
 
@@ -21,6 +25,12 @@ Shader ResourceManager::LoadShader(const char *vShaderFile,
 	Shaders[name] = shader;
 	return Shaders[name];
 }
+Shader ResourceManager::LoadComputeShader(const char *cShaderFile, std::string name) {
+	Shader shader;
+	shader.CompileCompute(cShaderFile);
+	Shaders[name] = shader;
+	return Shaders[name];
+}
 void ResourceManager::Init() {
 	stbi_set_flip_vertically_on_load(true);
 
@@ -28,6 +38,20 @@ void ResourceManager::Init() {
 			   "src/engine/utils/shaders/fSpriteShader.glsl",
 			   "SpriteShader");
 
+	LoadShader("src/engine/utils/shaders/vChunkShader.glsl",
+			   "src/engine/utils/shaders/fChunkShader.glsl",
+			   "ChunkShader");
+
+	LoadShader("src/engine/utils/shaders/vTilemapShader.glsl",
+			   "src/engine/utils/shaders/fTilemapShader.glsl",
+			   "TilemapShader");
+
+	LoadShader("src/engine/utils/shaders/vTilemapShader.glsl",
+			   "src/engine/utils/shaders/fLodShader.glsl",
+			   "LodShader");
+
+	LoadComputeShader("src/engine/utils/shaders/cChunkCullShader.glsl", "ChunkCullShader");
+
 	LoadShader("src/engine/utils/shaders/vLineShader.glsl",
 			   "src/engine/utils/shaders/fLineShader.glsl", "LineShader");
 
@@ -37,42 +61,45 @@ void ResourceManager::Init() {
 	LoadShader("src/engine/utils/shaders/vQuadShader.glsl",
 			   "src/engine/utils/shaders/fQuadShader.glsl", "QuadShader");
 
-	// Buildings
-	LoadTexture("CONVEYOR_STRAIGHT", 1.0f, "sprites/conveyors/conveyor_straight_up.png");
-	LoadTexture("FURNACE_SMALL", 1.0f, "sprites/buildings/furnace.png");
-	LoadTexture("FURNACE", 1.0f, "sprites/buildings/furnace_large.png");
-	LoadTexture("INSERTER", 1.0f, "sprites/buildings/inserter.png");
-
-	// UI
-	LoadTexture("INVENTORY_BACKGROUND", 1.0f, "sprites/UI/inventory_background.png");
-	LoadTexture("INVENTORY_SLOT", 1.0f, "sprites/UI/inventory_slot.png");
-	LoadTexture("TILE_SELCTOR", 1.0f, "sprites/UI/tile_selector.png");
-
-	// Items
-	LoadTexture("IRON_ORE_ITEM", 1.0f, "sprites/items/iron_ore.png");
-	LoadTexture("COPPER_ORE_ITEM", 1.0f, "sprites/items/copper_ore.png");
-	LoadTexture("COAL_ITEM", 1.0f, "sprites/items/coal.png");
-	LoadTexture("LEAVES_ITEM", 1.0f, "sprites/items/leaves.png");
-	LoadTexture("IRON_PLATE_ITEM", 1.0f, "sprites/items/iron_plate.png");
-	LoadTexture("COPPER_PLATE_ITEM", 1.0f, "sprites/items/copper_plate.png");
-	LoadTexture("GEARS_ITEM", 1.0f, "sprites/items/gears.png");
-	LoadTexture("WIRE_ITEM", 1.0f, "sprites/items/wire.png");
-	LoadTexture("CIRCUIT_BOARDS_ITEM", 1.0f, "sprites/items/circuit_board.png");
-
-	// Environment
-	LoadTexture("TREE", 1.0f, "sprites/environment/tree.png");
-	LoadTexture("TILE_SELCTOR", 1.0f, "sprites/environment/grass.png");
-
-	// Tiles
-	LoadTexture("GRASS_TILE_1", 1.0f, "sprites/tiles/grass_tile_1.png");
-	LoadTexture("GRASS_TILE_2", 1.0f, "sprites/tiles/grass_tile_2.png");
-	LoadTexture("GRASS_TILE_2", 1.0f, "sprites/tiles/grass_tile_2.png");
-
-	LoadTexture("WATER_TILE", 1.0f, "sprites/tiles/water_tile.png");
-	LoadTexture("SAND_TILE", 1.0f, "sprites/tiles/sand_tile.png");
-	LoadTexture("COPPER_ORE_TILE", 1.0f, "sprites/tiles/copper_ore_tile.png");
-	LoadTexture("COAL_ORE_TILE", 1.0f, "sprites/tiles/coal_ore_tile.png");
-	LoadTexture("IRON_ORE_TILE", 1.0f, "sprites/tiles/iron_ore_tile.png");
+	Task<void> textures = LoadTextures({
+		// Buildings
+		{"CONVEYOR_STRAIGHT", true, "sprites/conveyors/conveyor_straight_up.png"},
+		{"FURNACE_SMALL", true, "sprites/buildings/furnace.png"},
+		{"FURNACE", true, "sprites/buildings/furnace_large.png"},
+		{"INSERTER", true, "sprites/buildings/inserter.png"},
+
+		// UI
+		{"INVENTORY_BACKGROUND", true, "sprites/UI/inventory_background.png"},
+		{"INVENTORY_SLOT", true, "sprites/UI/inventory_slot.png"},
+		{"TILE_SELCTOR", true, "sprites/UI/tile_selector.png"},
+
+		// Items
+		{"IRON_ORE_ITEM", true, "sprites/items/iron_ore.png"},
+		{"COPPER_ORE_ITEM", true, "sprites/items/copper_ore.png"},
+		{"COAL_ITEM", true, "sprites/items/coal.png"},
+		{"LEAVES_ITEM", true, "sprites/items/leaves.png"},
+		{"IRON_PLATE_ITEM", true, "sprites/items/iron_plate.png"},
+		{"COPPER_PLATE_ITEM", true, "sprites/items/copper_plate.png"},
+		{"GEARS_ITEM", true, "sprites/items/gears.png"},
+		{"WIRE_ITEM", true, "sprites/items/wire.png"},
+		{"CIRCUIT_BOARDS_ITEM", true, "sprites/items/circuit_board.png"},
+
+		// Environment
+		{"TREE", true, "sprites/environment/tree.png"},
+		{"TILE_SELCTOR", true, "sprites/environment/grass.png"},
+
+		// Tiles
+		{"GRASS_TILE_1", true, "sprites/tiles/grass_tile_1.png"},
+		{"GRASS_TILE_2", true, "sprites/tiles/grass_tile_2.png"},
+		{"GRASS_TILE_2", true, "sprites/tiles/grass_tile_2.png"},
+
+		{"WATER_TILE", true, "sprites/tiles/water_tile.png"},
+		{"SAND_TILE", true, "sprites/tiles/sand_tile.png"},
+		{"COPPER_ORE_TILE", true, "sprites/tiles/copper_ore_tile.png"},
+		{"COAL_ORE_TILE", true, "sprites/tiles/coal_ore_tile.png"},
+		{"IRON_ORE_TILE", true, "sprites/tiles/iron_ore_tile.png"},
+	});
+	Async::MainThread().RunUntilComplete(textures);
 
     // Fonts
     LoadFont("Arial", "fonts/arial.ttf");
@@ -82,30 +109,87 @@ Shader ResourceManager::GetShader(std::string name) {
 	return Shaders[name];
 }
 
-Texture2D ResourceManager::LoadTexture(std::string name, bool alpha,
-									   const char *file) {
+// Pixels decoded by stb_image, waiting to be uploaded
+struct DecodedImage {
+	int width = 0;
+	int height = 0;
+	unsigned char *data = nullptr;
+};
+
+static DecodedImage DecodeImage(const char *file) {
+	DecodedImage image;
+	int nrChannels;
+	image.data = stbi_load(file, &image.width, &image.height, &nrChannels, STBI_rgb_alpha);
+	return image;
+}
+
+static Task<DecodedImage> DecodeImageAsync(std::string file) {
+	co_await Async::Pool().Schedule();
+	co_return DecodeImage(file.c_str());
+}
+
+// Must be called on the main thread; frees the image data
+static Texture2D UploadTexture(bool alpha, DecodedImage image) {
 	// create texture object
 	Texture2D texture = Texture2D();
 	if (alpha) {
 		texture.Internal_Format = GL_RGBA;
 		texture.Image_Format = GL_RGBA;
 	}
-
-	// load image
-	int width, height, nrChannels;
-	unsigned char *data = stbi_load(file, &width, &height, &nrChannels, STBI_rgb_alpha);
 	// now generate texture
-	texture.Generate(width, height, data);
+	texture.Generate(image.width, image.height, image.data);
 	// and finally free image data
-	stbi_image_free(data);
-	Textures[name] = texture;
+	stbi_image_free(image.data);
+	return texture;
+}
+
+Texture2D ResourceManager::LoadTexture(std::string name, bool alpha,
+									   const char *file) {
+	Textures[name] = UploadTexture(alpha, DecodeImage(file));
 	return Textures[name];
 }
 
+Task<void> ResourceManager::LoadTextures(std::vector<TextureRequest> requests) {
+	std::vector<Task<DecodedImage>> decodes;
+	for (const auto &request : requests) {
+		decodes.push_back(DecodeImageAsync(request.file));
+	}
+	std::vector<DecodedImage> images = co_await Async::WhenAll(std::move(decodes));
+
+	co_await Async::MainThread().NextFrame();
+	for (size_t i = 0; i < requests.size(); i++) {
+		Textures[requests[i].name] = UploadTexture(requests[i].alpha, images[i]);
+	}
+}
+
 Texture2D ResourceManager::GetTexture(std::string name) {
 	return Textures[name];
 }
 
+// Layers take the size of the first texture found; ones that differ are skipped
+TextureArray ResourceManager::LoadTextureArray(std::string name, const std::vector<std::string> &layers) {
+	std::vector<const Texture2D *> textures;
+	unsigned int width = 0, height = 0;
+	for (const std::string &layer : layers) {
+		auto it = layer.empty() ? Textures.end() : Textures.find(layer);
+		const Texture2D *texture = it == Textures.end() ? nullptr : &it->second;
+		if (texture && width == 0) {
+			width = texture->Width;
+			height = texture->Height;
+		}
+		textures.push_back(texture);
+	}
+
+	TextureArray array;
+	array.Generate(std::max(width, 1u), std::max(height, 1u), textures);
+	TextureArrays[name] = array;
+	return array;
+}
+
+TextureArray ResourceManager::GetTextureArray(std::string name) {
+	return TextureArrays[name];
+}
+
 void ResourceManager::LoadFont(std::string name, std::string path) {
 	FT_Library ft;
 	if (FT_Init_FreeType(&ft)) {
@@ -154,6 +238,8 @@ void ResourceManager::LoadFont(std::string name, std::string path) {
 		Fonts[name].characters.insert(std::pair<char, Character>(c, character));
 	}
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	// Glyphs were bound behind the state cache's back
+	GLState::Invalidate();
 	FT_Done_Face(face);
 	FT_Done_FreeType(ft);
 }
@@ -169,4 +255,6 @@ void ResourceManager::Clear() {
 	// (properly) delete all textures
 	for (auto iter : Textures)
 		glDeleteTextures(1, &iter.second.ID);
+	for (auto iter : TextureArrays)
+		glDeleteTextures(1, &iter.second.ID);
 }
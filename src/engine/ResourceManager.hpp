@@ -1,16 +1,26 @@
 #ifndef RESOURCE_MANAGER_H
 #define RESOURCE_MANAGER_H
 
+#include "async/Task.hpp"
 #include "utils/Shader.hpp"
 #include "utils/Texture.hpp"
+#include "utils/TextureArray.hpp"
 #include "utils/Font.h"
 #include <map>
 #include <string>
+#include <vector>
+
+struct TextureRequest {
+	std::string name;
+	bool alpha;
+	std::string file;
+};
 
 class ResourceManager {
   public:
 	// Instantiate static variables
 	static std::map<std::string, Texture2D> Textures;
+	static std::map<std::string, TextureArray> TextureArrays;
 	static std::map<std::string, Shader> Shaders;
 	static std::map<std::string, Font> Fonts;
 
@@ -19,12 +29,24 @@ class ResourceManager {
 	static Shader LoadShader(const char *vShaderFile,
 							 const char *fShaderFile, std::string name);
 
+	static Shader LoadComputeShader(const char *cShaderFile, std::string name);
+
 	static Shader GetShader(std::string name);
 
 	static Texture2D LoadTexture(std::string name, bool alpha, const char *file);
 
+	// Decodes every image on the thread pool, then uploads them on the main
+	// thread in request order
+	static Task<void> LoadTextures(std::vector<TextureRequest> requests);
+
 	static Texture2D GetTexture(std::string name);
 
+	// Copies already loaded textures into the layers of one array, in order.
+	// Empty or unknown names leave their layer transparent.
+	static TextureArray LoadTextureArray(std::string name, const std::vector<std::string> &layers);
+
+	static TextureArray GetTextureArray(std::string name);
+
 	static void LoadFont(std::string name, std::string path);
 
 	static Font GetFont(std::string name);
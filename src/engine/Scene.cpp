@@ -5,11 +5,14 @@
 void Scene::Start() {
 	for (auto *entity : entities) {
 		entity->StartComponents();
+		updates->Add(entity);
 	}
 }
 void Scene::Update() {
-	for (auto *entity : entities) {
-		entity->UpdateComponents();
+	updates->Update();
+	if (systems.GetSystemCount() > 0) {
+		systems.Run(DefaultRegistry());
+		systems.DrawImGui();
 	}
 }
 
@@ -2,11 +2,19 @@
 #define SCENE_H
 
 #include "ecs/Entity.hpp"
+#include "ecs/SystemScheduler.hpp"
+#include "ecs/UpdateSet.hpp"
+#include <memory>
 #include <vector>
 
 class Scene {
   public:
 	std::vector<Entity *> entities;
+	// Updates the entities with awake components. Shared so the scene can
+	// be copied into Simplex before it starts.
+	std::shared_ptr<UpdateSet> updates = std::make_shared<UpdateSet>();
+	// Run over the default registry each frame, after the components update
+	SystemScheduler systems;
 
 	Entity *GetCamera();
 
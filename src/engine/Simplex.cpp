@@ -3,6 +3,10 @@
 #include "ResourceManager.hpp"
 #include "Scene.hpp"
 #include "View.hpp"
+#include "async/Scheduler.hpp"
+#include "utils/BufferArena.hpp"
+#include "utils/GLState.hpp"
+#include <chrono>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <string>
@@ -16,6 +20,7 @@ float persistence = 0.1f;
 View view;
 Input input;
 Scene currentScene;
+Simulation simulation;
 bool firstLoop = true;
 
 void CreateWindow(std::string title, int width, int height) {
@@ -28,32 +33,61 @@ void CreateWindow(std::string title, int width, int height) {
 };
 
 void Quit() {
+	simulation.Stop();
+	Async::Shutdown();
 	view.Quit();
 }
 
 void SetScene(Scene scene) {
 	currentScene = scene;
-	view.Camera = scene.GetCamera();
+	Entity *camera = scene.GetCamera();
+	view.CameraId = camera ? camera->ID : NullEntity;
 };
 
 void Loop() {
 	if (firstLoop) {
 		currentScene.Start();
+		simulation.Start();
 		firstLoop = false;
 	}
+
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point rateStart = Clock::now();
+	int rateFrames = 0;
+	double framesPerSecond = 0.0;
 	while (!view.ShouldQuit()) {
 		ImGui_ImplOpenGL3_NewFrame();
 		ImGui_ImplGlfw_NewFrame();
 		ImGui::NewFrame();
 		input.PollEvents();
 
+		// Resume coroutines waiting for the main thread
+		Async::MainThread().RunFrame();
+		GLState::BeginFrame();
+
 		view.ClearColor(glm::vec4(0.2f, 0.3f, 0.3f, 1.0f));
 		currentScene.Update();
+		simulation.DrawImGui(framesPerSecond);
+		GpuArena().DrawImGui();
+		GLState::DrawImGui();
 
 		ImGui::Render();
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
 		view.SwapBuffers();
+
+		// Nothing from this frame holds entities past here
+		Entity::FlushDestroyed();
+		DefaultRegistry().AdvanceTick();
+		GpuArena().EndFrame();
+
+		rateFrames++;
+		Clock::time_point now = Clock::now();
+		if (now - rateStart >= std::chrono::seconds(1)) {
+			framesPerSecond = rateFrames / std::chrono::duration<double>(now - rateStart).count();
+			rateStart = now;
+			rateFrames = 0;
+		}
 	}
 	Quit();
 }
@@ -3,6 +3,7 @@
 
 #include "Input.hpp"
 #include "Scene.hpp"
+#include "Simulation.hpp"
 #include "View.hpp"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -13,6 +14,7 @@ namespace Simplex {
 extern View view;
 extern Input input;
 extern Scene currentScene;
+extern Simulation simulation;
 
 extern bool firstLoop;
 
@@ -0,0 +1,124 @@
+#include "Simulation.hpp"
+#include <algorithm>
+#include <imgui.h>
+
+Simulation::~Simulation() {
+	Stop();
+}
+
+void Simulation::Start(double ticksPerSecond) {
+	if (running) return;
+	tickSeconds = 1.0 / ticksPerSecond;
+	running = true;
+	thread = std::thread([this]() { Run(); });
+}
+
+void Simulation::Stop() {
+	running = false;
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+void Simulation::Post(std::function<void(Registry &)> command) {
+	std::lock_guard<std::mutex> lock(commandMutex);
+	commands.push_back(std::move(command));
+}
+
+// Ticks are scheduled against a fixed timeline rather than the end of the
+// previous tick, so the rate doesn't drift. After a slow tick the following
+// ones run back to back to catch up, up to MaxCatchUpTicks.
+void Simulation::Run() {
+	auto timestep = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(tickSeconds));
+	Clock::time_point next = Clock::now();
+	Clock::time_point rateStart = next;
+	uint64_t tick = 0;
+	uint64_t rateTicks = 0;
+
+	while (running) {
+		Clock::time_point start = Clock::now();
+		if (start < next) {
+			std::this_thread::sleep_until(next);
+			continue;
+		}
+
+		Tick(tick++);
+		Clock::time_point end = Clock::now();
+		next += timestep;
+		rateTicks++;
+
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.ticks = tick;
+		stats.lastTickMs = std::chrono::duration<double, std::milli>(end - start).count();
+		stats.averageTickMs =
+			stats.averageTickMs == 0.0 ? stats.lastTickMs : stats.averageTickMs * 0.95 + stats.lastTickMs * 0.05;
+		if (end - start > timestep) {
+			stats.overruns++;
+		}
+		if (end - next > timestep * MaxCatchUpTicks) {
+			stats.droppedTicks += (end - next) / timestep;
+			next = end;
+		}
+		if (end - rateStart >= std::chrono::seconds(1)) {
+			stats.ticksPerSecond = rateTicks / std::chrono::duration<double>(end - rateStart).count();
+			rateStart = end;
+			rateTicks = 0;
+		}
+	}
+}
+
+void Simulation::Tick(uint64_t tick) {
+	std::vector<std::function<void(Registry &)>> pending;
+	{
+		std::lock_guard<std::mutex> lock(commandMutex);
+		pending.swap(commands);
+	}
+	for (auto &command : pending) {
+		command(registry);
+	}
+
+	systems.Run(registry);
+	registry.FlushDestroyed();
+
+	ComponentPool<RenderSprite> &sprites = registry.Pool<RenderSprite>();
+	RenderState state;
+	state.tick = tick;
+	state.entities = sprites.Entities();
+	state.sprites = sprites.Components();
+	renderStates.Publish(std::move(state));
+	registry.AdvanceTick();
+}
+
+float Simulation::InterpolationAlpha(Clock::time_point published) const {
+	double elapsed = std::chrono::duration<double>(Clock::now() - published).count();
+	return static_cast<float>(std::clamp(elapsed / tickSeconds, 0.0, 1.0));
+}
+
+RenderSprite Simulation::Interpolate(const RenderSprite &from, const RenderSprite &to, float alpha) {
+	RenderSprite sprite;
+	sprite.position = from.position + (to.position - from.position) * alpha;
+	sprite.size = from.size + (to.size - from.size) * alpha;
+	sprite.rotation = from.rotation + (to.rotation - from.rotation) * alpha;
+	sprite.texture = to.texture;
+	return sprite;
+}
+
+SimulationStats Simulation::GetStats() const {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	return stats;
+}
+
+void Simulation::DrawImGui(double framesPerSecond) const {
+	SimulationStats current = GetStats();
+
+	ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+	ImGui::Begin("Simulation");
+	ImGui::Text("FPS: %.1f", framesPerSecond);
+	ImGui::Text("UPS: %.1f / %.0f", current.ticksPerSecond, 1.0 / tickSeconds);
+	ImGui::Text("Tick: %.3f ms (avg %.3f ms, budget %.3f ms)", current.lastTickMs, current.averageTickMs,
+				tickSeconds * 1000.0);
+	ImGui::Text("Ticks: %llu", static_cast<unsigned long long>(current.ticks));
+	ImGui::Text("Overruns: %llu", static_cast<unsigned long long>(current.overruns));
+	ImGui::Text("Dropped: %llu", static_cast<unsigned long long>(current.droppedTicks));
+	ImGui::End();
+}
@@ -0,0 +1,119 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "ecs/Registry.hpp"
+#include "ecs/SystemScheduler.hpp"
+#include "utils/TickBuffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm/ext/vector_float2.hpp>
+#include <glm/ext/vector_float3.hpp>
+
+// Where a simulated entity is drawn. Simulation systems write these; each
+// tick they are copied out for the main thread to draw.
+struct RenderSprite {
+	glm::vec3 position = glm::vec3(0.0f);
+	glm::vec2 size = glm::vec2(1.0f);
+	// Radians, about the sprite's centre
+	float rotation = 0.0f;
+	// GL texture; sprites without one aren't drawn
+	unsigned int texture = 0;
+};
+
+// Everything the main thread needs to draw one tick
+struct RenderState {
+	uint64_t tick = 0;
+	std::vector<EntityId> entities;
+	std::vector<RenderSprite> sprites; // Parallel to entities
+};
+
+struct SimulationStats {
+	double ticksPerSecond = 0.0; // Measured over the last second
+	double lastTickMs = 0.0;
+	double averageTickMs = 0.0;
+	uint64_t ticks = 0;
+	uint64_t overruns = 0;	   // Ticks that took longer than the timestep
+	uint64_t droppedTicks = 0; // Ticks skipped after falling too far behind
+};
+
+// Fixed-rate simulation on its own thread, so the world keeps ticking at
+// full rate however long a frame takes to draw. The simulation owns its
+// registry; the main thread talks to it through Post and reads it back as
+// the render state of the last two ticks, interpolated to the current time.
+class Simulation {
+  public:
+	static constexpr double DefaultTicksPerSecond = 60.0;
+	// How far behind a slow tick may leave the clock before the backlog is
+	// dropped rather than run back to back
+	static constexpr int MaxCatchUpTicks = 5;
+
+	// Runs once per tick on the simulation thread. Add systems before Start.
+	SystemScheduler systems;
+
+	~Simulation();
+
+	void Start(double ticksPerSecond = DefaultTicksPerSecond);
+	void Stop();
+	bool IsRunning() const { return running; }
+
+	// Run a command on the simulation thread before the next tick, e.g. to
+	// create entities
+	void Post(std::function<void(Registry &)> command);
+
+	double GetTickSeconds() const { return tickSeconds; }
+
+	// fn(entity, sprite) for every sprite of the latest tick, moved towards
+	// where it will be at the next one by how far into the tick we are.
+	// Sprites that weren't at the same slot a tick earlier aren't moved.
+	template <typename Fn>
+	void ForEachSprite(Fn fn) const {
+		TickBuffer<RenderState>::Frame frame = renderStates.Read();
+		if (!frame.current) return;
+
+		float alpha = InterpolationAlpha(frame.published);
+		const RenderState &current = *frame.current;
+		const RenderState *previous = frame.previous.get();
+		for (size_t i = 0; i < current.entities.size(); i++) {
+			const RenderSprite &sprite = current.sprites[i];
+			if (!previous || i >= previous->entities.size() || previous->entities[i] != current.entities[i]) {
+				fn(current.entities[i], sprite);
+				continue;
+			}
+			fn(current.entities[i], Interpolate(previous->sprites[i], sprite, alpha));
+		}
+	}
+
+	SimulationStats GetStats() const;
+
+	// Tick rate, frame rate and overruns
+	void DrawImGui(double framesPerSecond) const;
+
+  private:
+	using Clock = std::chrono::steady_clock;
+
+	// Only touched by the simulation thread once started
+	Registry registry;
+	std::thread thread;
+	std::atomic<bool> running{false};
+	double tickSeconds = 1.0 / DefaultTicksPerSecond;
+
+	std::vector<std::function<void(Registry &)>> commands;
+	std::mutex commandMutex;
+
+	TickBuffer<RenderState> renderStates;
+
+	mutable std::mutex statsMutex;
+	SimulationStats stats;
+
+	void Run();
+	void Tick(uint64_t tick);
+	float InterpolationAlpha(Clock::time_point published) const;
+	static RenderSprite Interpolate(const RenderSprite &from, const RenderSprite &to, float alpha);
+};
+
+#endif
@@ -80,6 +80,12 @@ struct UIElement {
 };
 
 class UI {
+	// One quad draws every element, rather than a vertex array each
+	static Quad &QuadModel() {
+		static Quad *quad = new Quad();
+		return *quad;
+	}
+
 	UIElement Root = {};
 	UIElement *currentElement = &Root;
 
@@ -166,15 +172,13 @@ class UI {
 			childPosition.x += leftOffset;
 			childPosition.y += elem.properties.padding.top;
 
-			Quad quad = Quad();
-			quad.Render(childPosition, child.size, child.properties.backgroundColor);
+			QuadModel().Render(childPosition, child.size, child.properties.backgroundColor);
 			leftOffset += child.size.x + elem.properties.childGap;
 			RenderElementChildren(child, childPosition);
 		}
 	}
 
 	void Render() {
-		Quad quad = Quad();
 		RenderElementChildren(Root, Root.position);
 	};
 };
@@ -13,8 +13,11 @@ void View::Init(std::string title, int width, int height) {
 	Title = title;
 
 	glfwInit();
+	// 4.5 for direct state access; drivers still hand back their newest
+	// version, and 4.6 features are used when present. Mesa's software
+	// renderer stops at 4.5.
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
 	window = glfwCreateWindow(Width, Height, Title.c_str(), NULL, NULL);
@@ -83,3 +86,7 @@ glm::vec2 View::GetMousePosition() {
 	glm::vec2 mousePos = glm::vec2((float)mouseX, Height - (float)mouseY);
 	return mousePos;
 }
+
+Entity *View::GetCamera() {
+	return Entity::Find(CameraId);
+}
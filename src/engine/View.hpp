@@ -15,7 +15,8 @@ class View {
 	int Height;
 	std::string Title;
 
-	Entity *Camera;
+	// Handle rather than pointer, so a destroyed camera reads as none
+	EntityId CameraId = NullEntity;
 
 	void Init(std::string title, int width, int height);
 	bool ShouldQuit();
@@ -24,6 +25,8 @@ class View {
 	void SwapBuffers();
 
 	glm::vec2 GetMousePosition();
+	// Camera entity, or nullptr if there is none
+	Entity *GetCamera();
 
 	static void FramebufferSizeCallback(GLFWwindow *window, int newWidth, int newHeight);
 };
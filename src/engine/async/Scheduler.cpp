@@ -0,0 +1,233 @@
+#include "Scheduler.hpp"
+#include <algorithm>
+#include <exception>
+
+namespace Async {
+
+static thread_local int currentWorker = -1;
+
+ThreadPool::ThreadPool(size_t threadCount) {
+	threadCount = std::max<size_t>(threadCount, 1);
+	for (size_t i = 0; i < threadCount; i++) {
+		counters.push_back(std::make_unique<WorkerCounters>());
+	}
+	for (size_t i = 0; i < threadCount; i++) {
+		workers.emplace_back([this, i]() { WorkerThread(static_cast<int>(i)); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	Stop();
+}
+
+void ThreadPool::Stop() {
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		if (shouldStop) return;
+		shouldStop = true;
+	}
+	queueCondition.notify_all();
+
+	for (auto &worker : workers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(queueMutex);
+	jobs = {};
+}
+
+void ThreadPool::Enqueue(std::coroutine_handle<> handle, int priority) {
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		jobs.push({priority, nextSequence++, handle});
+	}
+	queueCondition.notify_one();
+}
+
+size_t ThreadPool::GetQueueSize() const {
+	std::lock_guard<std::mutex> lock(queueMutex);
+	return jobs.size();
+}
+
+std::vector<WorkerStats> ThreadPool::GetWorkerStats() const {
+	std::vector<WorkerStats> stats;
+	for (const auto &counter : counters) {
+		stats.push_back({counter->busyNs, counter->idleNs, counter->jobs});
+	}
+	return stats;
+}
+
+void ThreadPool::ResetWorkerStats() {
+	for (auto &counter : counters) {
+		counter->busyNs = 0;
+		counter->idleNs = 0;
+		counter->jobs = 0;
+	}
+}
+
+int ThreadPool::CurrentWorker() {
+	return currentWorker;
+}
+
+void ThreadPool::WorkerThread(int workerIndex) {
+	using Clock = std::chrono::steady_clock;
+	currentWorker = workerIndex;
+	WorkerCounters &counter = *counters[workerIndex];
+
+	while (true) {
+		std::coroutine_handle<> handle;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			Clock::time_point waitStart = Clock::now();
+			queueCondition.wait(lock, [this] { return !jobs.empty() || shouldStop; });
+			counter.idleNs += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - waitStart).count();
+
+			if (shouldStop) break;
+
+			handle = jobs.top().handle;
+			jobs.pop();
+		}
+
+		Clock::time_point start = Clock::now();
+		handle.resume();
+		counter.busyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+		counter.jobs++;
+	}
+}
+
+void MainThreadQueue::Enqueue(std::coroutine_handle<> handle) {
+	{
+		std::lock_guard<std::mutex> lock(pendingMutex);
+		pending.push_back(handle);
+	}
+	pendingCondition.notify_one();
+}
+
+void MainThreadQueue::RunFrame() {
+	std::vector<std::coroutine_handle<>> ready;
+	{
+		std::lock_guard<std::mutex> lock(pendingMutex);
+		ready.swap(pending);
+	}
+	for (auto handle : ready) {
+		handle.resume();
+	}
+}
+
+void MainThreadQueue::Discard() {
+	std::lock_guard<std::mutex> lock(pendingMutex);
+	pending.clear();
+}
+
+// Finishes on the main thread so the flag is only ever touched there
+static Task<void> SignalOnMainThread(MainThreadQueue &queue, Task<void> &task, bool &finished, std::exception_ptr &error) {
+	try {
+		co_await task;
+	} catch (...) {
+		error = std::current_exception();
+	}
+	co_await queue.NextFrame();
+	finished = true;
+}
+
+void MainThreadQueue::RunUntilComplete(Task<void> &task) {
+	bool finished = false;
+	std::exception_ptr error = nullptr;
+
+	Task<void> signal = SignalOnMainThread(*this, task, finished, error);
+	signal.Start();
+	while (!finished) {
+		{
+			std::unique_lock<std::mutex> lock(pendingMutex);
+			pendingCondition.wait(lock, [this] { return !pending.empty(); });
+		}
+		RunFrame();
+	}
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+namespace {
+
+// Items of one ParallelFor, shared with helpers that may only get to run
+// after the call has returned
+struct ParallelForState {
+	const std::function<void(size_t)> *work = nullptr; // Valid until done == count
+	size_t count = 0;
+	std::atomic<size_t> next{0};
+	size_t done = 0;
+	std::exception_ptr error = nullptr;
+	std::mutex mutex;
+	std::condition_variable finished;
+
+	// Run items until none are left to claim
+	void Drain() {
+		size_t ran = 0;
+		std::exception_ptr firstError = nullptr;
+		for (size_t i = next++; i < count; i = next++) {
+			try {
+				(*work)(i);
+			} catch (...) {
+				if (!firstError) firstError = std::current_exception();
+			}
+			ran++;
+		}
+		if (ran == 0) return;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (firstError && !error) error = firstError;
+		done += ran;
+		if (done == count) finished.notify_all();
+	}
+};
+
+Task<void> ParallelForHelper(std::shared_ptr<ParallelForState> state, int priority) {
+	co_await Pool().Schedule(priority);
+	state->Drain();
+}
+
+} // namespace
+
+void ParallelFor(size_t count, const std::function<void(size_t)> &work, int priority) {
+	if (count == 0) return;
+
+	auto state = std::make_shared<ParallelForState>();
+	state->work = &work;
+	state->count = count;
+
+	size_t helpers = std::min(count - 1, Pool().GetThreadCount());
+	for (size_t i = 0; i < helpers; i++) {
+		Spawn(ParallelForHelper(state, priority));
+	}
+	state->Drain();
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->finished.wait(lock, [&] { return state->done == state->count; });
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
+
+ThreadPool &Pool() {
+	static ThreadPool pool;
+	return pool;
+}
+
+MainThreadQueue &MainThread() {
+	static MainThreadQueue queue;
+	return queue;
+}
+
+// The queued handles are frames inside the detached coroutines' chains, so
+// they are only dropped here and destroyed through their roots
+void Shutdown() {
+	Pool().Stop();
+	MainThread().Discard();
+	detail::DestroyDetached();
+}
+
+} // namespace Async
@@ -0,0 +1,143 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "Task.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Async {
+
+struct WorkerStats {
+	uint64_t busyNs = 0;
+	uint64_t idleNs = 0;
+	size_t jobs = 0;
+};
+
+// Worker threads that resume coroutines in priority order (higher first,
+// then first come first served)
+class ThreadPool {
+  public:
+	explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+	~ThreadPool();
+
+	// Join the workers. Jobs still queued are dropped without being resumed;
+	// their frames are freed by whoever owns them, see Shutdown.
+	void Stop();
+
+	// co_await pool.Schedule(priority) continues the coroutine on a worker
+	struct ScheduleAwaiter {
+		ThreadPool &pool;
+		int priority;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> handle) { pool.Enqueue(handle, priority); }
+		void await_resume() const noexcept {}
+	};
+	ScheduleAwaiter Schedule(int priority = 0) { return {*this, priority}; }
+
+	size_t GetThreadCount() const { return workers.size(); }
+	size_t GetQueueSize() const;
+	std::vector<WorkerStats> GetWorkerStats() const;
+	void ResetWorkerStats();
+
+	// Index of the calling worker, or -1 off the pool
+	static int CurrentWorker();
+
+  private:
+	struct Job {
+		int priority;
+		uint64_t sequence;
+		std::coroutine_handle<> handle;
+
+		bool operator<(const Job &other) const {
+			if (priority != other.priority) {
+				return priority < other.priority;
+			}
+			return sequence > other.sequence;
+		}
+	};
+
+	struct WorkerCounters {
+		std::atomic<uint64_t> busyNs{0};
+		std::atomic<uint64_t> idleNs{0};
+		std::atomic<size_t> jobs{0};
+	};
+
+	std::vector<std::thread> workers;
+	std::vector<std::unique_ptr<WorkerCounters>> counters;
+	std::priority_queue<Job> jobs;
+	uint64_t nextSequence = 0;
+	mutable std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	bool shouldStop = false;
+
+	void Enqueue(std::coroutine_handle<> handle, int priority);
+	void WorkerThread(int workerIndex);
+};
+
+// Coroutines waiting to continue on the main thread. Drained once per frame
+// by Simplex::Loop.
+class MainThreadQueue {
+  public:
+	// co_await mainThread.NextFrame() continues the coroutine on the main
+	// thread at the start of the next frame
+	struct NextFrameAwaiter {
+		MainThreadQueue &queue;
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> handle) { queue.Enqueue(handle); }
+		void await_resume() const noexcept {}
+	};
+	NextFrameAwaiter NextFrame() { return {*this}; }
+
+	// Resume everything queued before this call; coroutines queued while
+	// running wait for the following frame
+	void RunFrame();
+
+	// Block the main thread until the task completes, running queued
+	// continuations as they arrive. For loading before the first frame;
+	// rethrows the task's exception.
+	void RunUntilComplete(Task<void> &task);
+
+	// Drop everything queued without resuming it, for Shutdown
+	void Discard();
+
+  private:
+	std::vector<std::coroutine_handle<>> pending;
+	std::mutex pendingMutex;
+	std::condition_variable pendingCondition;
+
+	void Enqueue(std::coroutine_handle<> handle);
+};
+
+ThreadPool &Pool();
+MainThreadQueue &MainThread();
+
+// Stop the pool and free every spawned coroutine that hasn't finished, along
+// with the tasks it awaits, so their cleanup runs instead of leaking at quit.
+// Nothing may be resumed through either queue afterwards.
+void Shutdown();
+
+// Priority of work the current frame is blocked on, ahead of everything else
+constexpr int FramePriority = INT_MAX;
+
+// Run work(i) for every i in [0, count) across the pool, returning once all
+// have finished. The calling thread takes items as well, so it never waits on
+// workers busy with longer jobs and calls can nest. Rethrows the first
+// exception thrown by any item.
+void ParallelFor(size_t count, const std::function<void(size_t)> &work, int priority = FramePriority);
+
+} // namespace Async
+
+#endif
@@ -0,0 +1,332 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <atomic>
+#include <coroutine>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Lazily started coroutine returning a T. Awaiting a task starts it and
+// resumes the awaiting coroutine, on whichever thread the task finished on,
+// once it completes.
+template <typename T = void>
+class Task;
+
+namespace Async {
+namespace detail {
+
+struct PromiseBase {
+	std::coroutine_handle<> continuation = nullptr;
+	std::exception_ptr exception = nullptr;
+
+	struct FinalAwaiter {
+		bool await_ready() noexcept { return false; }
+		template <typename Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+			std::coroutine_handle<> continuation = handle.promise().continuation;
+			return continuation ? continuation : std::noop_coroutine();
+		}
+		void await_resume() noexcept {}
+	};
+
+	std::suspend_always initial_suspend() noexcept { return {}; }
+	FinalAwaiter final_suspend() noexcept { return {}; }
+	void unhandled_exception() { exception = std::current_exception(); }
+
+	void RethrowIfFailed() {
+		if (exception) {
+			std::rethrow_exception(exception);
+		}
+	}
+};
+
+} // namespace detail
+} // namespace Async
+
+template <typename T>
+class Task {
+  public:
+	struct promise_type : Async::detail::PromiseBase {
+		std::optional<T> value;
+
+		Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		void return_value(T result) { value.emplace(std::move(result)); }
+
+		T Result() {
+			RethrowIfFailed();
+			return std::move(*value);
+		}
+	};
+
+	Task() = default;
+	explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+	Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	Task &operator=(Task &&other) noexcept {
+		if (this != &other) {
+			if (handle) handle.destroy();
+			handle = std::exchange(other.handle, nullptr);
+		}
+		return *this;
+	}
+	Task(const Task &) = delete;
+	Task &operator=(const Task &) = delete;
+	~Task() {
+		if (handle) handle.destroy();
+	}
+
+	bool Done() const { return !handle || handle.done(); }
+
+	bool await_ready() const noexcept { return !handle || handle.done(); }
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+		handle.promise().continuation = awaiting;
+		return handle;
+	}
+	T await_resume() { return handle.promise().Result(); }
+
+  private:
+	std::coroutine_handle<promise_type> handle = nullptr;
+};
+
+template <>
+class Task<void> {
+  public:
+	struct promise_type : Async::detail::PromiseBase {
+		Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		void return_void() {}
+
+		void Result() { RethrowIfFailed(); }
+	};
+
+	Task() = default;
+	explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+	Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	Task &operator=(Task &&other) noexcept {
+		if (this != &other) {
+			if (handle) handle.destroy();
+			handle = std::exchange(other.handle, nullptr);
+		}
+		return *this;
+	}
+	Task(const Task &) = delete;
+	Task &operator=(const Task &) = delete;
+	~Task() {
+		if (handle) handle.destroy();
+	}
+
+	bool Done() const { return !handle || handle.done(); }
+
+	// Start a task without awaiting it; only for driving a task to completion
+	// from outside a coroutine
+	void Start() {
+		if (handle && !handle.done()) handle.resume();
+	}
+
+	bool await_ready() const noexcept { return !handle || handle.done(); }
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+		handle.promise().continuation = awaiting;
+		return handle;
+	}
+	void await_resume() { handle.promise().Result(); }
+
+	// Rethrows if the task finished with an exception
+	void Result() { handle.promise().Result(); }
+
+  private:
+	std::coroutine_handle<promise_type> handle = nullptr;
+};
+
+namespace Async {
+namespace detail {
+
+// Frames of detached coroutines that haven't finished. Each owns the chain of
+// tasks it awaits, so destroying these frees everything still suspended.
+struct DetachedFrames {
+	std::mutex mutex;
+	std::unordered_set<void *> frames;
+};
+
+inline DetachedFrames &Detached() {
+	static DetachedFrames detached;
+	return detached;
+}
+
+// Fire-and-forget coroutine that frees itself when it finishes
+struct DetachedTask {
+	struct promise_type {
+		promise_type() {
+			std::lock_guard<std::mutex> lock(Detached().mutex);
+			Detached().frames.insert(std::coroutine_handle<promise_type>::from_promise(*this).address());
+		}
+		~promise_type() {
+			std::lock_guard<std::mutex> lock(Detached().mutex);
+			Detached().frames.erase(std::coroutine_handle<promise_type>::from_promise(*this).address());
+		}
+
+		DetachedTask get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() {
+			try {
+				throw;
+			} catch (const std::exception &e) {
+				printf("Unhandled exception in detached task: %s\n", e.what());
+			} catch (...) {
+				printf("Unhandled exception in detached task\n");
+			}
+		}
+	};
+};
+
+inline DetachedTask RunDetached(Task<void> task) {
+	co_await task;
+}
+
+// Destroy every detached coroutine still suspended, running the destructors
+// of their locals. Only once nothing can resume them any more.
+inline void DestroyDetached() {
+	std::unordered_set<void *> frames;
+	{
+		std::lock_guard<std::mutex> lock(Detached().mutex);
+		frames.swap(Detached().frames);
+	}
+	for (void *frame : frames) {
+		std::coroutine_handle<>::from_address(frame).destroy();
+	}
+}
+
+struct WhenAllCounter {
+	std::atomic<size_t> remaining{0};
+	std::coroutine_handle<> continuation = nullptr;
+};
+
+// Wraps one task of a WhenAll; the last one to finish resumes the awaiter
+struct WhenAllItem {
+	struct promise_type {
+		WhenAllCounter *counter = nullptr;
+
+		struct FinalAwaiter {
+			bool await_ready() noexcept { return false; }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+				WhenAllCounter *counter = handle.promise().counter;
+				if (counter->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					return counter->continuation;
+				}
+				return std::noop_coroutine();
+			}
+			void await_resume() noexcept {}
+		};
+
+		WhenAllItem get_return_object() { return WhenAllItem(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		FinalAwaiter final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+
+	std::coroutine_handle<promise_type> handle;
+
+	explicit WhenAllItem(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+	WhenAllItem(WhenAllItem &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	WhenAllItem(const WhenAllItem &) = delete;
+	~WhenAllItem() {
+		if (handle) handle.destroy();
+	}
+};
+
+template <typename T>
+WhenAllItem MakeWhenAllItem(Task<T> &task, std::optional<T> &result, std::exception_ptr &error) {
+	try {
+		result.emplace(co_await task);
+	} catch (...) {
+		error = std::current_exception();
+	}
+}
+
+inline WhenAllItem MakeWhenAllItem(Task<void> &task, std::exception_ptr &error) {
+	try {
+		co_await task;
+	} catch (...) {
+		error = std::current_exception();
+	}
+}
+
+// Starts every item and suspends the awaiter until all have finished. The
+// extra count held by the awaiter keeps an item that finishes synchronously
+// from resuming it before it has suspended.
+struct WhenAllAwaiter {
+	std::vector<WhenAllItem> &items;
+	WhenAllCounter counter;
+
+	explicit WhenAllAwaiter(std::vector<WhenAllItem> &items) : items(items) {}
+
+	bool await_ready() const noexcept { return items.empty(); }
+	bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+		counter.remaining = items.size() + 1;
+		counter.continuation = awaiting;
+		for (auto &item : items) {
+			item.handle.promise().counter = &counter;
+			item.handle.resume();
+		}
+		return counter.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+	}
+	void await_resume() noexcept {}
+};
+
+} // namespace detail
+
+// Run a task to completion in the background. The task owns itself;
+// exceptions are logged.
+inline void Spawn(Task<void> task) {
+	detail::RunDetached(std::move(task));
+}
+
+// Await every task concurrently and collect their results in order. The
+// first exception thrown by any task is rethrown once all have finished.
+template <typename T>
+Task<std::vector<T>> WhenAll(std::vector<Task<T>> tasks) {
+	std::vector<std::optional<T>> results(tasks.size());
+	std::vector<std::exception_ptr> errors(tasks.size());
+
+	std::vector<detail::WhenAllItem> items;
+	items.reserve(tasks.size());
+	for (size_t i = 0; i < tasks.size(); i++) {
+		items.push_back(detail::MakeWhenAllItem(tasks[i], results[i], errors[i]));
+	}
+	co_await detail::WhenAllAwaiter{items};
+
+	for (auto &error : errors) {
+		if (error) std::rethrow_exception(error);
+	}
+
+	std::vector<T> values;
+	values.reserve(results.size());
+	for (auto &result : results) {
+		values.push_back(std::move(*result));
+	}
+	co_return values;
+}
+
+inline Task<void> WhenAll(std::vector<Task<void>> tasks) {
+	std::vector<std::exception_ptr> errors(tasks.size());
+
+	std::vector<detail::WhenAllItem> items;
+	items.reserve(tasks.size());
+	for (size_t i = 0; i < tasks.size(); i++) {
+		items.push_back(detail::MakeWhenAllItem(tasks[i], errors[i]));
+	}
+	co_await detail::WhenAllAwaiter{items};
+
+	for (auto &error : errors) {
+		if (error) std::rethrow_exception(error);
+	}
+}
+
+} // namespace Async
+
+#endif
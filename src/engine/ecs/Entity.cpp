@@ -2,11 +2,46 @@
 #include "IComponent.hpp"
 #include <vector>
 
-void Entity::AddComponent(IComponent *component) {
-	component->entity = this;
-	Components.push_back(component);
+Entity::~Entity() {
+	if (updateSet) {
+		updateSet->Remove(this);
+	}
+	DefaultRegistry().Destroy(ID);
+	for (auto *component : Components) {
+		delete component;
+	}
+	Components.clear();
 };
 
+Entity *Entity::Find(EntityId id) {
+	Entity **entity = DefaultRegistry().TryGet<Entity *>(id);
+	return entity && !(*entity)->destroyQueued ? *entity : nullptr;
+}
+
+std::vector<Entity *> &Entity::DestroyQueue() {
+	static std::vector<Entity *> queue;
+	return queue;
+}
+
+void Entity::Destroy() {
+	if (destroyQueued) return;
+	destroyQueued = true;
+	DestroyQueue().push_back(this);
+}
+
+void Entity::FlushDestroyed() {
+	// Deleting an entity can queue others, e.g. ones its components own
+	std::vector<Entity *> &queue = DestroyQueue();
+	while (!queue.empty()) {
+		std::vector<Entity *> pending;
+		pending.swap(queue);
+		for (Entity *entity : pending) {
+			delete entity;
+		}
+	}
+	DefaultRegistry().FlushDestroyed();
+}
+
 void Entity::StartComponents() {
 	for (size_t i = 0; i < Components.size(); i++) {
 		IComponent *component = Components[i];
@@ -15,8 +50,59 @@ void Entity::StartComponents() {
 };
 
 void Entity::UpdateComponents() {
-	for (size_t i = 0; i < Components.size(); i++) {
-		IComponent *component = Components[i];
-		component->Update();
+	if (awakeDirty) {
+		awakeComponents.clear();
+		for (IComponent *component : Components) {
+			if (component->IsAwake()) awakeComponents.push_back(component);
+		}
+		awakeDirty = false;
+	}
+	for (size_t i = 0; i < awakeComponents.size(); i++) {
+		IComponent *component = awakeComponents[i];
+		if (component->IsAwake()) component->Update();
 	}
 };
+
+void Entity::OnComponentWoke() {
+	awakeDirty = true;
+	if (awakeCount++ == 0 && updateSet) {
+		updateSet->OnEntityWoke(this);
+	}
+}
+
+void Entity::OnComponentSlept() {
+	awakeDirty = true;
+	if (--awakeCount == 0 && updateSet) {
+		updateSet->OnEntitySlept(this);
+	}
+}
+
+void IComponent::Wake() {
+	if (pendingWakeup != std::chrono::steady_clock::time_point{}) {
+		pendingWakeup = {};
+		wakeupSerial++;
+	}
+	if (awake) return;
+	awake = true;
+	if (entity) entity->OnComponentWoke();
+}
+
+void IComponent::Sleep() {
+	if (!awake) return;
+	awake = false;
+	if (entity) entity->OnComponentSlept();
+}
+
+void IComponent::WakeAfter(double seconds) {
+	using Clock = std::chrono::steady_clock;
+	WakeAt(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+}
+
+void IComponent::WakeAt(std::chrono::steady_clock::time_point time) {
+	if (!entity || !entity->updateSet) return;
+	Sleep();
+	// An earlier wakeup already covers this one
+	if (pendingWakeup != std::chrono::steady_clock::time_point{} && pendingWakeup <= time) return;
+	pendingWakeup = time;
+	entity->updateSet->WakeAt(this, time);
+}
@@ -2,41 +2,104 @@
 #define ENTITY_H
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include "IComponent.hpp"
+#include "Registry.hpp"
+#include "../utils/BlockPool.hpp"
+#include "UpdateSet.hpp"
 
 #define ENTITY(name, ...) \
     Entity* name = new Entity; \
-    name->AddComponents({__VA_ARGS__}); \
+    name->AddComponents(__VA_ARGS__); \
     entities.push_back(name);
 
+// Object-style facade over the default registry for components that are
+// IComponent subclasses. Each component is registered as a pointer under the
+// exact type it was added as, so GetComponent is a sparse set lookup instead
+// of a scan. Hold an entity by its ID where it may outlive the current frame;
+// Find turns it back into a pointer, or nullptr once the entity is gone.
 class Entity {
   public:
-	int ID;
+	EntityId ID;
 
+	// In the order they were added, for Start and Update
 	std::vector<IComponent *> Components;
 
-	void AddComponent(IComponent *component);
-	void AddComponents(std::initializer_list<IComponent *> components) {
-		for (auto *component : components) {
-			AddComponent(component);
+	Entity() : ID(DefaultRegistry().Create()) { DefaultRegistry().Add<Entity *>(ID, this); }
+	Entity(const Entity &) = delete;
+	Entity &operator=(const Entity &) = delete;
+
+	// Entities own their components. Use Destroy rather than deleting an
+	// entity directly, so pointers taken earlier in the frame stay valid.
+	virtual ~Entity();
+
+	// Entities come from pooled blocks
+	static void *operator new(size_t size) { return BlockPool::Allocate(size); }
+	static void operator delete(void *block, size_t size) { BlockPool::Free(block, size); }
+
+	// nullptr if the entity was destroyed
+	static Entity *Find(EntityId id);
+
+	// Queue the entity for deletion at the end of the frame. Find stops
+	// returning it straight away.
+	void Destroy();
+	bool IsDestroyed() const { return destroyQueued; }
+
+	// Delete the entities queued by Destroy. Simplex calls this once the
+	// frame is done.
+	static void FlushDestroyed();
+
+	template <typename T>
+	T *AddComponent(T *component) {
+		component->entity = this;
+		Components.push_back(component);
+		DefaultRegistry().Add<T *>(ID, component);
+		awakeDirty = true;
+		if (component->IsAwake()) {
+			OnComponentWoke();
 		}
+		return component;
+	}
+	template <typename... Ts>
+	void AddComponents(Ts *...components) {
+		(AddComponent(components), ...);
 	};
 
+	// Looks up the exact type the component was added as
 	template <typename T>
 	T *GetComponent() {
-		for (size_t i = 0; i < Components.size(); i++) {
-			IComponent *component = Components[i];
-
-			if (T *casted = dynamic_cast<T *>(component)) {
-				return casted;
-			}
-		}
-		return nullptr;
+		T **component = DefaultRegistry().TryGet<T *>(ID);
+		return component ? *component : nullptr;
 	};
 
 	void StartComponents();
+	// Updates the awake components
 	void UpdateComponents();
+
+	bool IsAwake() const { return awakeCount > 0; }
+	UpdateSet *GetUpdateSet() const { return updateSet; }
+
+  private:
+	friend class IComponent;
+	friend class UpdateSet;
+	static constexpr size_t NotListed = SIZE_MAX;
+
+	bool destroyQueued = false;
+
+	UpdateSet *updateSet = nullptr;
+	size_t memberIndex = NotListed; // In updateSet's members
+	size_t awakeIndex = NotListed;	// In updateSet's awake entities
+	size_t awakeCount = 0;
+	// Awake components in the order they were added, rebuilt when one wakes
+	// or sleeps so a component changing state mid-update doesn't disturb it
+	std::vector<IComponent *> awakeComponents;
+	bool awakeDirty = true;
+
+	void OnComponentWoke();
+	void OnComponentSlept();
+
+	static std::vector<Entity *> &DestroyQueue();
 };
 
 #endif
@@ -1,6 +1,11 @@
 #ifndef ICOMPONENT_H
 #define ICOMPONENT_H
 
+#include "../utils/BlockPool.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
 class Entity;
 
 #define COMPONENT(component) AddComponent(new component)
@@ -9,8 +14,36 @@ class IComponent {
   public:
 	Entity *entity = nullptr;
 
+	virtual ~IComponent() {};
+
+	// Components come from pooled blocks
+	static void *operator new(size_t size) { return BlockPool::Allocate(size); }
+	static void operator delete(void *block, size_t size) { BlockPool::Free(block, size); }
+
 	virtual void Start() {};
 	virtual void Update() {};
+
+	// Update is only called while the component is awake, which it is by
+	// default. Components with nothing to do each frame sleep, from their
+	// constructor or once their work runs out, and are woken by whatever
+	// gives them work again.
+	void Wake();
+	void Sleep();
+	bool IsAwake() const { return awake; }
+
+	// Sleep until the time has passed. Needs the entity to be in an
+	// UpdateSet, which keeps the timer; otherwise the component stays awake.
+	void WakeAfter(double seconds);
+	void WakeAt(std::chrono::steady_clock::time_point time);
+
+  private:
+	friend class UpdateSet;
+
+	bool awake = true;
+	// Earliest timed wakeup queued since the component last woke, if any.
+	// Waking bumps the serial, which cancels every queued wakeup.
+	std::chrono::steady_clock::time_point pendingWakeup = {};
+	uint32_t wakeupSerial = 0;
 };
 
 #endif
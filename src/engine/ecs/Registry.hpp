@@ -0,0 +1,420 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Slot index in the low 32 bits and the slot's generation in the high 32.
+// Destroying an entity bumps its slot's generation, so old handles stop
+// resolving instead of finding whatever reuses the slot.
+using EntityId = uint64_t;
+constexpr EntityId NullEntity = UINT64_MAX;
+
+inline uint32_t EntityIndex(EntityId entity) {
+	return static_cast<uint32_t>(entity);
+}
+inline uint32_t EntityGeneration(EntityId entity) {
+	return static_cast<uint32_t>(entity >> 32);
+}
+inline EntityId MakeEntityId(uint32_t index, uint32_t generation) {
+	return static_cast<EntityId>(generation) << 32 | index;
+}
+
+// Types can be first used from the simulation thread and the main thread at
+// once, so the counter is atomic; each id only has to be unique
+inline size_t NextComponentTypeId() {
+	static std::atomic<size_t> next = 0;
+	return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Dense index for each component type, assigned on first use
+template <typename T>
+size_t ComponentTypeId() {
+	static const size_t id = NextComponentTypeId();
+	return id;
+}
+
+class IComponentPool {
+  public:
+	virtual ~IComponentPool() {};
+	virtual bool Has(EntityId entity) const = 0;
+	virtual void Remove(EntityId entity) = 0;
+	virtual size_t Size() const = 0;
+	virtual void TrimRemovals(uint64_t beforeTick) = 0;
+};
+
+// Sparse set of one component type. Components sit packed in an array next
+// to the entities that own them, so iterating a pool walks memory linearly;
+// a paged sparse array maps an entity's index to its slot in O(1), and the
+// owner stored in the slot rejects stale handles. Removal moves the
+// last component into the hole, so adding or removing components of a type
+// invalidates pointers to other components of that type.
+//
+// Writes through Patch or MarkChanged, and adds, stamp the component with the
+// registry's tick and log it once per tick, so readers can ask what changed
+// since a tick of their own in time proportional to the changes. The log is
+// compacted down to each component's latest change as it grows, so no reader
+// ever loses a change; removals are kept for RemovalHistoryTicks.
+template <typename T>
+class ComponentPool : public IComponentPool {
+  public:
+	explicit ComponentPool(const uint64_t *clock = nullptr) : clock(clock) {}
+
+	template <typename... Args>
+	T &Emplace(EntityId entity, Args &&...args) {
+		uint32_t &slot = SparseSlot(entity);
+		if (slot != Absent) {
+			dense[slot] = entity;
+			components[slot] = T(std::forward<Args>(args)...);
+			Stamp(slot);
+			return components[slot];
+		}
+		slot = static_cast<uint32_t>(dense.size());
+		dense.push_back(entity);
+		components.emplace_back(std::forward<Args>(args)...);
+		changedTicks.push_back(NeverChanged);
+		Stamp(slot);
+		return components.back();
+	}
+
+	void Remove(EntityId entity) override {
+		uint32_t slot = Find(entity);
+		if (slot == Absent) return;
+
+		EntityId last = dense.back();
+		if (slot != dense.size() - 1) {
+			dense[slot] = last;
+			components[slot] = std::move(components.back());
+			changedTicks[slot] = changedTicks.back();
+			SparseSlot(last) = slot;
+		}
+		dense.pop_back();
+		components.pop_back();
+		changedTicks.pop_back();
+		SparseSlot(entity) = Absent;
+		removals.push_back({Now(), entity});
+	}
+
+	// Mutable access that records the write; nullptr if absent
+	T *Patch(EntityId entity) {
+		uint32_t slot = Find(entity);
+		if (slot == Absent) return nullptr;
+		Stamp(slot);
+		return &components[slot];
+	}
+
+	void MarkChanged(EntityId entity) {
+		uint32_t slot = Find(entity);
+		if (slot != Absent) Stamp(slot);
+	}
+
+	// fn(entity, T &) for every component added or changed at or after
+	// tick, each once, oldest change first
+	template <typename Fn>
+	void ForEachChangedSince(uint64_t tick, Fn fn) {
+		auto first = std::lower_bound(changes.begin(), changes.end(), tick,
+									  [](const Change &change, uint64_t value) { return change.tick < value; });
+		for (size_t i = first - changes.begin(); i < changes.size(); i++) {
+			uint32_t slot = Find(changes[i].entity);
+			// Skip entries superseded by a later change of the same component
+			if (slot == Absent || changedTicks[slot] != changes[i].tick) continue;
+			fn(changes[i].entity, components[slot]);
+		}
+	}
+
+	// fn(entity) for every component removed at or after tick. Returns
+	// false without calling fn if removals that far back were discarded;
+	// the reader then has to rescan the pool.
+	template <typename Fn>
+	bool ForEachRemovedSince(uint64_t tick, Fn fn) const {
+		if (tick < removalsFrom) return false;
+		auto first = std::lower_bound(removals.begin(), removals.end(), tick,
+									  [](const Change &change, uint64_t value) { return change.tick < value; });
+		for (; first != removals.end(); ++first) {
+			fn(first->entity);
+		}
+		return true;
+	}
+
+	// Tick the component was last added or changed in
+	uint64_t ChangedTick(EntityId entity) const {
+		uint32_t slot = Find(entity);
+		return slot == Absent ? 0 : changedTicks[slot];
+	}
+
+	void TrimRemovals(uint64_t beforeTick) override {
+		auto last = std::lower_bound(removals.begin(), removals.end(), beforeTick,
+									 [](const Change &change, uint64_t value) { return change.tick < value; });
+		removals.erase(removals.begin(), last);
+		removalsFrom = std::max(removalsFrom, beforeTick);
+	}
+
+	size_t GetChangeLogSize() const { return changes.size(); }
+
+	bool Has(EntityId entity) const override { return Find(entity) != Absent; }
+
+	T *TryGet(EntityId entity) {
+		uint32_t slot = Find(entity);
+		return slot == Absent ? nullptr : &components[slot];
+	}
+
+	size_t Size() const override { return dense.size(); }
+
+	// Owner of each component, in the same order as Components()
+	const std::vector<EntityId> &Entities() const { return dense; }
+	std::vector<T> &Components() { return components; }
+
+  private:
+	static constexpr uint32_t Absent = UINT32_MAX;
+	static constexpr size_t PageSize = 4096;
+	static constexpr uint64_t NeverChanged = UINT64_MAX;
+
+	struct Change {
+		uint64_t tick;
+		EntityId entity;
+	};
+
+	std::vector<std::unique_ptr<uint32_t[]>> pages;
+	std::vector<EntityId> dense;
+	std::vector<T> components;
+	std::vector<uint64_t> changedTicks; // Parallel to dense
+	std::vector<Change> changes;		// In tick order
+	std::vector<Change> removals;		// In tick order
+	uint64_t removalsFrom = 0;
+	const uint64_t *clock;
+
+	uint64_t Now() const { return clock ? *clock : 0; }
+
+	void Stamp(uint32_t slot) {
+		uint64_t now = Now();
+		if (changedTicks[slot] == now) return;
+		changedTicks[slot] = now;
+		changes.push_back({now, dense[slot]});
+		if (changes.size() > 2 * dense.size() + 1024) {
+			CompactChanges();
+		}
+	}
+
+	// Keep only each live component's latest entry, in order
+	void CompactChanges() {
+		size_t kept = 0;
+		for (const Change &change : changes) {
+			uint32_t slot = Find(change.entity);
+			if (slot != Absent && changedTicks[slot] == change.tick) {
+				changes[kept++] = change;
+			}
+		}
+		changes.resize(kept);
+	}
+
+	uint32_t Find(EntityId entity) const {
+		size_t page = EntityIndex(entity) / PageSize;
+		if (page >= pages.size() || !pages[page]) return Absent;
+		uint32_t slot = pages[page][EntityIndex(entity) % PageSize];
+		return slot != Absent && dense[slot] == entity ? slot : Absent;
+	}
+
+	uint32_t &SparseSlot(EntityId entity) {
+		size_t page = EntityIndex(entity) / PageSize;
+		if (page >= pages.size()) {
+			pages.resize(page + 1);
+		}
+		if (!pages[page]) {
+			pages[page] = std::make_unique<uint32_t[]>(PageSize);
+			std::fill(pages[page].get(), pages[page].get() + PageSize, Absent);
+		}
+		return pages[page][EntityIndex(entity) % PageSize];
+	}
+};
+
+// Entities that have every one of Ts. Iteration is driven by the smallest
+// of the pools, so its cost follows the rarest component.
+template <typename... Ts>
+class RegistryView {
+  public:
+	explicit RegistryView(ComponentPool<Ts> &...pools) : pools(&pools...) {}
+
+	// Call fn(entity, Ts &...) for each match. Walks backwards so fn may
+	// remove the current entity's components or destroy it.
+	template <typename Fn>
+	void Each(Fn fn) {
+		const std::vector<EntityId> &driver = Smallest();
+		for (size_t i = driver.size(); i-- > 0;) {
+			if (i >= driver.size()) continue;
+			EntityId entity = driver[i];
+			std::tuple<Ts *...> components(std::get<ComponentPool<Ts> *>(pools)->TryGet(entity)...);
+			if (!(std::get<Ts *>(components) && ...)) continue;
+			std::apply([&](Ts *...component) { fn(entity, *component...); }, components);
+		}
+	}
+
+	size_t SizeHint() const { return Smallest().size(); }
+
+  private:
+	std::tuple<ComponentPool<Ts> *...> pools;
+
+	const std::vector<EntityId> &Smallest() const {
+		const std::vector<EntityId> *smallest = nullptr;
+		((smallest = !smallest || std::get<ComponentPool<Ts> *>(pools)->Size() < smallest->size()
+						 ? &std::get<ComponentPool<Ts> *>(pools)->Entities()
+						 : smallest),
+		 ...);
+		return *smallest;
+	}
+};
+
+// Entity handles plus one pool per component type. Slots of destroyed
+// entities are reused under a new generation. Main thread only, except that
+// DestroyLater may be called from systems running on the pool.
+class Registry {
+  public:
+	// How long removals stay queryable through ForEachRemovedSince
+	static constexpr uint64_t RemovalHistoryTicks = 600;
+
+	// Ticks start at 1, so 0 means "since the beginning"
+	uint64_t GetTick() const { return tick; }
+
+	// Later writes get a new tick. Called at the end of each frame or
+	// simulation tick, and whenever a reader consumes changes.
+	void AdvanceTick() {
+		tick++;
+		if (tick > RemovalHistoryTicks && tick % 64 == 0) {
+			for (auto &pool : pools) {
+				if (pool) pool->TrimRemovals(tick - RemovalHistoryTicks);
+			}
+		}
+	}
+
+	EntityId Create() {
+		if (!freeIndices.empty()) {
+			uint32_t index = freeIndices.back();
+			freeIndices.pop_back();
+			alive[index] = true;
+			return MakeEntityId(index, generations[index]);
+		}
+		alive.push_back(true);
+		generations.push_back(0);
+		return MakeEntityId(static_cast<uint32_t>(alive.size() - 1), 0);
+	}
+
+	// Removes every component of the entity and frees its slot
+	void Destroy(EntityId entity) {
+		if (!Alive(entity)) return;
+		for (auto &pool : pools) {
+			if (pool) pool->Remove(entity);
+		}
+		uint32_t index = EntityIndex(entity);
+		alive[index] = false;
+		generations[index]++;
+		freeIndices.push_back(index);
+	}
+
+	// Destroy at the next FlushDestroyed, so systems still iterating over
+	// the entity this tick aren't pulled out from under
+	void DestroyLater(EntityId entity) {
+		std::lock_guard<std::mutex> lock(pendingMutex);
+		pendingDestroy.push_back(entity);
+	}
+
+	// Safe point for DestroyLater, at the end of a tick
+	void FlushDestroyed() {
+		std::vector<EntityId> pending;
+		{
+			std::lock_guard<std::mutex> lock(pendingMutex);
+			pending.swap(pendingDestroy);
+		}
+		for (EntityId entity : pending) {
+			Destroy(entity);
+		}
+	}
+
+	bool Alive(EntityId entity) const {
+		uint32_t index = EntityIndex(entity);
+		return entity != NullEntity && index < alive.size() && alive[index] && generations[index] == EntityGeneration(entity);
+	}
+
+	size_t GetEntityCount() const { return alive.size() - freeIndices.size(); }
+
+	template <typename T, typename... Args>
+	T &Add(EntityId entity, Args &&...args) {
+		return Pool<T>().Emplace(entity, std::forward<Args>(args)...);
+	}
+
+	template <typename T>
+	void Remove(EntityId entity) {
+		Pool<T>().Remove(entity);
+	}
+
+	template <typename T>
+	bool Has(EntityId entity) {
+		return Pool<T>().Has(entity);
+	}
+
+	// nullptr if the entity doesn't have a T
+	template <typename T>
+	T *TryGet(EntityId entity) {
+		return Pool<T>().TryGet(entity);
+	}
+
+	// Mutable access that records the write for change queries
+	template <typename T>
+	T *Patch(EntityId entity) {
+		return Pool<T>().Patch(entity);
+	}
+
+	template <typename T>
+	void MarkChanged(EntityId entity) {
+		Pool<T>().MarkChanged(entity);
+	}
+
+	// fn(entity, T &) for each T changed since the cursor, then move the
+	// cursor past them. Starts a new tick so writes after the call are told
+	// apart, which gives each reader every change exactly once.
+	template <typename T, typename Fn>
+	void ConsumeChanges(uint64_t &cursor, Fn fn) {
+		Pool<T>().ForEachChangedSince(cursor, fn);
+		AdvanceTick();
+		cursor = tick;
+	}
+
+	template <typename T>
+	ComponentPool<T> &Pool() {
+		size_t type = ComponentTypeId<T>();
+		if (type >= pools.size()) {
+			pools.resize(type + 1);
+		}
+		if (!pools[type]) {
+			pools[type] = std::make_unique<ComponentPool<T>>(&tick);
+		}
+		return static_cast<ComponentPool<T> &>(*pools[type]);
+	}
+
+	template <typename... Ts>
+	RegistryView<Ts...> View() {
+		return RegistryView<Ts...>(Pool<Ts>()...);
+	}
+
+  private:
+	uint64_t tick = 1;
+	std::vector<std::unique_ptr<IComponentPool>> pools;
+	std::vector<bool> alive;
+	std::vector<uint32_t> generations;
+	std::vector<uint32_t> freeIndices;
+	std::vector<EntityId> pendingDestroy;
+	std::mutex pendingMutex;
+};
+
+// Registry behind the Entity facade
+inline Registry &DefaultRegistry() {
+	static Registry registry;
+	return registry;
+}
+
+#endif
@@ -0,0 +1,126 @@
+#include "SystemScheduler.hpp"
+#include "../async/Scheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <imgui.h>
+
+static bool Overlaps(const std::vector<size_t> &a, const std::vector<size_t> &b) {
+	for (size_t type : a) {
+		if (std::find(b.begin(), b.end(), type) != b.end()) return true;
+	}
+	return false;
+}
+
+bool SystemAccess::ConflictsWith(const SystemAccess &other) const {
+	if (exclusive || other.exclusive) return true;
+	return Overlaps(writes, other.writes) || Overlaps(writes, other.reads) || Overlaps(reads, other.writes);
+}
+
+void SystemAccess::CreatePools(Registry &registry) const {
+	for (auto createPool : createPools) {
+		createPool(registry);
+	}
+}
+
+void SystemScheduler::Add(std::string name, SystemAccess access, SystemFn run) {
+	System system;
+	system.name = std::move(name);
+	system.access = std::move(access);
+	system.run = std::move(run);
+	systems.push_back(std::move(system));
+	dirty = true;
+}
+
+// Each system lands one stage after the latest earlier system it conflicts
+// with, so anything it has to wait for has finished by the time it runs
+void SystemScheduler::Build() {
+	stages.clear();
+	for (size_t i = 0; i < systems.size(); i++) {
+		System &system = systems[i];
+		system.after.clear();
+		system.stage = 0;
+		for (size_t j = 0; j < i; j++) {
+			if (!system.access.ConflictsWith(systems[j].access)) continue;
+			system.after.push_back(j);
+			system.stage = std::max(system.stage, systems[j].stage + 1);
+		}
+		if (system.stage >= stages.size()) {
+			stages.resize(system.stage + 1);
+		}
+		stages[system.stage].push_back(i);
+	}
+	dirty = false;
+}
+
+void SystemScheduler::RunSystem(System &system, Registry &registry) {
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point start = Clock::now();
+	system.run(registry);
+	system.lastMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	system.averageMs = system.averageMs == 0.0 ? system.lastMs : system.averageMs * 0.95 + system.lastMs * 0.05;
+	system.worker = Async::ThreadPool::CurrentWorker();
+}
+
+void SystemScheduler::Run(Registry &registry) {
+	using Clock = std::chrono::steady_clock;
+	if (dirty) {
+		Build();
+	}
+	for (const System &system : systems) {
+		system.access.CreatePools(registry);
+	}
+
+	Clock::time_point start = Clock::now();
+	std::vector<System *> pooled;
+	for (const std::vector<size_t> &stage : stages) {
+		pooled.clear();
+		for (size_t index : stage) {
+			if (systems[index].access.IsMainThread()) {
+				RunSystem(systems[index], registry);
+			} else {
+				pooled.push_back(&systems[index]);
+			}
+		}
+		Async::ParallelFor(pooled.size(), [&](size_t i) { RunSystem(*pooled[i], registry); });
+	}
+	lastRunMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	averageRunMs = averageRunMs == 0.0 ? lastRunMs : averageRunMs * 0.95 + lastRunMs * 0.05;
+}
+
+void SystemScheduler::DrawImGui() {
+	ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+	ImGui::Begin("Systems");
+
+	double serialMs = 0.0;
+	for (const System &system : systems) {
+		serialMs += system.averageMs;
+	}
+	ImGui::Text("%zu systems in %zu stages, %zu workers", systems.size(), stages.size(),
+				Async::Pool().GetThreadCount());
+	ImGui::Text("Frame: %.3f ms (%.3f ms run one after another)", averageRunMs, serialMs);
+
+	for (size_t s = 0; s < stages.size(); s++) {
+		ImGui::SeparatorText(("Stage " + std::to_string(s)).c_str());
+		for (size_t index : stages[s]) {
+			const System &system = systems[index];
+			std::string thread = system.access.IsMainThread() ? "main"
+								 : system.worker < 0		  ? "main (helping)"
+															  : "worker " + std::to_string(system.worker);
+			ImGui::Text("%-24s %7.3f ms avg  %7.3f ms last  %s", system.name.c_str(), system.averageMs, system.lastMs,
+						thread.c_str());
+
+			std::string access = system.access.IsExclusive()
+									 ? "exclusive"
+									 : std::to_string(system.access.GetReads().size()) + " reads, " +
+										   std::to_string(system.access.GetWrites().size()) + " writes";
+			if (!system.after.empty()) {
+				access += ", after";
+				for (size_t dependency : system.after) {
+					access += " " + systems[dependency].name;
+				}
+			}
+			ImGui::TextDisabled("  %s", access.c_str());
+		}
+	}
+	ImGui::End();
+}
@@ -0,0 +1,106 @@
+#ifndef SYSTEM_SCHEDULER_H
+#define SYSTEM_SCHEDULER_H
+
+#include "Registry.hpp"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Component types a system reads and writes. Systems conflict when either
+// writes a type the other touches, and conflicting systems never run at once.
+// A system on the pool may only touch the pools it declares; creating or
+// destroying entities touches every pool, so that needs Exclusive().
+class SystemAccess {
+  public:
+	template <typename... Ts>
+	SystemAccess &Read() {
+		(Declare<Ts>(reads), ...);
+		return *this;
+	}
+
+	template <typename... Ts>
+	SystemAccess &Write() {
+		(Declare<Ts>(writes), ...);
+		return *this;
+	}
+
+	// Conflicts with every other system
+	SystemAccess &Exclusive() {
+		exclusive = true;
+		return *this;
+	}
+
+	// Runs on the main thread, for systems that use GL or ImGui
+	SystemAccess &MainThread() {
+		mainThread = true;
+		return *this;
+	}
+
+	bool ConflictsWith(const SystemAccess &other) const;
+
+	const std::vector<size_t> &GetReads() const { return reads; }
+	const std::vector<size_t> &GetWrites() const { return writes; }
+	bool IsExclusive() const { return exclusive; }
+	bool IsMainThread() const { return mainThread; }
+
+	// Create the declared pools, so running systems never resize the
+	// registry's pool list
+	void CreatePools(Registry &registry) const;
+
+  private:
+	std::vector<size_t> reads;
+	std::vector<size_t> writes;
+	std::vector<void (*)(Registry &)> createPools;
+	bool exclusive = false;
+	bool mainThread = false;
+
+	template <typename T>
+	void Declare(std::vector<size_t> &types) {
+		types.push_back(ComponentTypeId<T>());
+		createPools.push_back([](Registry &registry) { registry.Pool<T>(); });
+	}
+};
+
+using SystemFn = std::function<void(Registry &)>;
+
+// Runs systems once per frame, in parallel where their access allows. Each
+// system waits for the earlier-registered systems it conflicts with, so
+// conflicting systems always run in registration order. Systems are grouped
+// into stages by how long that chain of waits is; a stage's systems are
+// free of conflicts and run together across the job pool and the main thread.
+class SystemScheduler {
+  public:
+	void Add(std::string name, SystemAccess access, SystemFn run);
+
+	void Run(Registry &registry);
+
+	// Stages, dependencies and timings
+	void DrawImGui();
+
+	size_t GetSystemCount() const { return systems.size(); }
+	size_t GetStageCount() const { return stages.size(); }
+
+  private:
+	struct System {
+		std::string name;
+		SystemAccess access;
+		SystemFn run;
+		std::vector<size_t> after; // Earlier systems it conflicts with
+		size_t stage = 0;
+		double lastMs = 0.0;
+		double averageMs = 0.0;
+		int worker = -1; // Pool worker it last ran on, -1 for the main thread
+	};
+
+	std::vector<System> systems;
+	std::vector<std::vector<size_t>> stages;
+	bool dirty = false;
+	double lastRunMs = 0.0;
+	double averageRunMs = 0.0;
+
+	void Build();
+	static void RunSystem(System &system, Registry &registry);
+};
+
+#endif
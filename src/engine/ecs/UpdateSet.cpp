@@ -0,0 +1,124 @@
+#include "UpdateSet.hpp"
+#include "Entity.hpp"
+#include "IComponent.hpp"
+#include <algorithm>
+
+UpdateSet::~UpdateSet() {
+	for (Entity *entity : members) {
+		entity->updateSet = nullptr;
+		entity->awakeIndex = Entity::NotListed;
+	}
+}
+
+void UpdateSet::Add(Entity *entity) {
+	if (entity->updateSet == this) return;
+	if (entity->updateSet) {
+		entity->updateSet->Remove(entity);
+	}
+	entity->updateSet = this;
+	entity->memberIndex = members.size();
+	members.push_back(entity);
+	if (entity->awakeCount > 0) {
+		OnEntityWoke(entity);
+	}
+}
+
+void UpdateSet::Remove(Entity *entity) {
+	if (entity->updateSet != this) return;
+	RemoveAwake(entity);
+
+	Entity *last = members.back();
+	members[entity->memberIndex] = last;
+	last->memberIndex = entity->memberIndex;
+	members.pop_back();
+	entity->updateSet = nullptr;
+	entity->memberIndex = Entity::NotListed;
+	UpdateOwner();
+}
+
+void UpdateSet::Update() {
+	Clock::time_point now = Clock::now();
+	while (!wakeups.empty() && wakeups.top().time <= now) {
+		Wakeup wakeup = wakeups.top();
+		wakeups.pop();
+
+		// The entity may have been destroyed or moved since, and the
+		// component woken by something else
+		Entity *entity = Entity::Find(wakeup.entity);
+		if (!entity || entity->updateSet != this) continue;
+		if (std::find(entity->Components.begin(), entity->Components.end(), wakeup.component) == entity->Components.end()) {
+			continue;
+		}
+		if (wakeup.component->wakeupSerial == wakeup.serial) {
+			wakeup.component->Wake();
+		}
+	}
+
+	updating = true;
+	size_t count = awake.size();
+	for (size_t i = 0; i < count; i++) {
+		Entity *entity = awake[i];
+		if (entity && !entity->IsDestroyed()) {
+			entity->UpdateComponents();
+		}
+	}
+	updating = false;
+
+	if (removedWhileUpdating > 0) {
+		awake.erase(std::remove(awake.begin(), awake.end(), nullptr), awake.end());
+		for (size_t i = 0; i < awake.size(); i++) {
+			awake[i]->awakeIndex = i;
+		}
+		removedWhileUpdating = 0;
+	}
+	UpdateOwner();
+}
+
+void UpdateSet::WakeAt(IComponent *component, Clock::time_point time) {
+	if (!component->entity) return;
+	wakeups.push({time, component->entity->ID, component, component->wakeupSerial});
+	UpdateOwner();
+}
+
+void UpdateSet::OnEntityWoke(Entity *entity) {
+	if (entity->awakeIndex != Entity::NotListed) return;
+	entity->awakeIndex = awake.size();
+	awake.push_back(entity);
+	UpdateOwner();
+}
+
+void UpdateSet::OnEntitySlept(Entity *entity) {
+	RemoveAwake(entity);
+	UpdateOwner();
+}
+
+// Entities are only taken out of awake between updates; during one their
+// slot is cleared and compacted afterwards, so the loop never skips anyone
+void UpdateSet::RemoveAwake(Entity *entity) {
+	size_t index = entity->awakeIndex;
+	if (index == Entity::NotListed) return;
+	entity->awakeIndex = Entity::NotListed;
+
+	if (updating) {
+		awake[index] = nullptr;
+		removedWhileUpdating++;
+		return;
+	}
+	Entity *last = awake.back();
+	awake[index] = last;
+	last->awakeIndex = index;
+	awake.pop_back();
+}
+
+// The owner only needs to run while there is an awake entity. With nothing
+// but timed wakeups left it sleeps until the earliest one.
+void UpdateSet::UpdateOwner() {
+	if (!owner) return;
+	if (awake.size() > removedWhileUpdating) {
+		owner->Wake();
+	} else if (!wakeups.empty()) {
+		owner->WakeAt(wakeups.top().time);
+	} else {
+		owner->Sleep();
+	}
+}
@@ -0,0 +1,74 @@
+#ifndef UPDATE_SET_H
+#define UPDATE_SET_H
+
+#include "Registry.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+class Entity;
+class IComponent;
+
+// Entities updated together, e.g. a scene's entities. An entity in the set is
+// only updated while at least one of its components is awake, so sleeping
+// entities cost nothing per frame. Components wake and sleep themselves, or
+// sleep with a timed wakeup that the set keeps.
+//
+// A set can belong to a component that updates it. The owner is woken when
+// the set gains an awake entity or a timed wakeup, and put to sleep when the
+// set has neither, so a whole idle subtree drops out of the update.
+class UpdateSet {
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit UpdateSet(IComponent *owner = nullptr) : owner(owner) {}
+	UpdateSet(const UpdateSet &) = delete;
+	UpdateSet &operator=(const UpdateSet &) = delete;
+	~UpdateSet();
+
+	// An entity belongs to at most one set; adding moves it here
+	void Add(Entity *entity);
+	void Remove(Entity *entity);
+
+	// Fire due wakeups, then update every awake entity. Entities that wake
+	// during the update start next frame.
+	void Update();
+
+	size_t GetEntityCount() const { return members.size(); }
+	size_t GetAwakeCount() const { return awake.size() - removedWhileUpdating; }
+	size_t GetPendingWakeups() const { return wakeups.size(); }
+
+  private:
+	friend class Entity;
+	friend class IComponent;
+
+	struct Wakeup {
+		Clock::time_point time;
+		EntityId entity;
+		IComponent *component;
+		uint32_t serial;
+
+		bool operator>(const Wakeup &other) const { return time > other.time; }
+	};
+
+	IComponent *owner;
+	std::vector<Entity *> members;
+	std::vector<Entity *> awake;
+	// Slots of awake cleared during Update, compacted after it
+	size_t removedWhileUpdating = 0;
+	std::priority_queue<Wakeup, std::vector<Wakeup>, std::greater<Wakeup>> wakeups;
+	bool updating = false;
+
+	// Called by Entity as its first component wakes and its last one sleeps
+	void OnEntityWoke(Entity *entity);
+	// Queue a wakeup for a component of an entity in this set
+	void WakeAt(IComponent *component, Clock::time_point time);
+	void OnEntitySlept(Entity *entity);
+	void RemoveAwake(Entity *entity);
+	void UpdateOwner();
+};
+
+#endif
@@ -9,44 +9,50 @@
 #include <glm/ext/vector_float2.hpp>
 #include <glm/ext/vector_float3.hpp>
 #include <glm/glm.hpp>
-#include "../../utils/SSBOBuffer.hpp"
+#include "../../utils/BufferArena.hpp"
+#include "../../utils/CameraBuffer.hpp"
+#include "../../utils/GLState.hpp"
+#include <unordered_map>
+#include <vector>
 #include "../../Simplex.hpp"
 #include "Camera.hpp"
 
-struct bigModel : Model {
-	SSBO<unsigned int> ssbo;
-	bigModel() : Model(), ssbo(SSBO<unsigned int>()) {
-		ssbo.Bind();
-	};
-	void fillSSBO(std::vector<unsigned int> buf) {
-		ssbo.Fill(buf);
-		SIZE = ssbo.size / 2 * 6;
-	}
-};
-
+// Draws the simulation's sprites as they are at this frame, interpolated
+// between its last two ticks. The sprites are streamed through the GPU arena
+// each frame and drawn with one call per texture.
 struct Renderer : IComponent {
-	bigModel model = bigModel();
+	Model model;
 
 	Renderer() {};
 	void Update() override {
+		for (auto &[texture, sprites] : batches) {
+			sprites.clear();
+		}
+		Simplex::simulation.ForEachSprite([&](EntityId, const RenderSprite &sprite) {
+			if (sprite.texture == 0) return;
+			std::vector<glm::vec4> &sprites = batches[sprite.texture];
+			sprites.push_back(glm::vec4(sprite.position, sprite.rotation));
+			sprites.push_back(glm::vec4(sprite.size.x, sprite.size.y, 0.0f, 0.0f));
+		});
+
 		Shader shader = ResourceManager::GetShader("SpriteShader");
 		shader.use();
-
-		glm::mat4 projection = glm::mat4(1.0f);
-		if (Simplex::view.Camera != nullptr) {
-			projection = Simplex::view.Camera->GetComponent<Camera>()->CalcualteScreenSpaceProjection();
+		Cameras().Bind();
+		for (auto &[texture, sprites] : batches) {
+			if (sprites.empty()) continue;
+			ArenaAllocation block = GpuArena().Stream(sprites);
+			if (!block) continue;
+
+			GpuArena().BindStorage(0, block);
+			GLState::BindTextureUnit(0, texture);
+			model.SIZE = sprites.size() / 2 * 6;
+			model.Render(GL_TRIANGLES);
 		}
-
-		shader.setVec4("color", glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
-
-		shader.setMat4("projection", projection);
-
-		glActiveTexture(GL_TEXTURE0);
-		ResourceManager::GetTexture("GRASS_TILE_1").Bind();
-		model.Render(GL_TRIANGLES);
-		glBindTexture(GL_TEXTURE0, 0);
-
 	}
+
+  private:
+	// Two vec4s per sprite, by texture. Kept between frames for the capacity.
+	std::unordered_map<unsigned int, std::vector<glm::vec4>> batches;
 };
 
 #endif
@@ -10,7 +10,7 @@ struct Transform : public IComponent {
 	glm::vec2 Size = glm::vec2(1.0f, 1.0f);
 	float Rotation = 0.0f;
 
-	void Update() override {};
+	Transform() { Sleep(); };
 };
 
 #endif
@@ -0,0 +1,101 @@
+#ifndef BLOCK_POOL_H
+#define BLOCK_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Storage for small objects that are created and destroyed often, such as
+// entities and their components. Sizes are rounded up to 16 bytes; each size
+// class carves blocks from 64 KiB slabs and reuses freed ones through a free
+// list, so churn never reaches the system allocator. Slabs are kept for the
+// life of the program. Thread safe.
+namespace BlockPool {
+
+constexpr size_t Granularity = 16;
+constexpr size_t MaxBlockSize = 1024;
+constexpr size_t SlabBytes = 64 * 1024;
+
+namespace detail {
+
+struct SizeClass {
+	std::mutex mutex;
+	void *freeList = nullptr;
+	std::byte *slab = nullptr;
+	size_t slabUsed = SlabBytes;
+	size_t liveBlocks = 0;
+	size_t slabs = 0;
+};
+
+// Never destroyed, so objects freed during static destruction are safe
+inline std::array<SizeClass, MaxBlockSize / Granularity> &Classes() {
+	static auto *classes = new std::array<SizeClass, MaxBlockSize / Granularity>();
+	return *classes;
+}
+
+inline size_t ClassIndex(size_t size) {
+	return (size - 1) / Granularity;
+}
+
+} // namespace detail
+
+inline void *Allocate(size_t size) {
+	if (size == 0) size = 1;
+	if (size > MaxBlockSize) return ::operator new(size);
+
+	detail::SizeClass &sizeClass = detail::Classes()[detail::ClassIndex(size)];
+	size_t blockSize = (detail::ClassIndex(size) + 1) * Granularity;
+
+	std::lock_guard<std::mutex> lock(sizeClass.mutex);
+	sizeClass.liveBlocks++;
+	if (sizeClass.freeList) {
+		void *block = sizeClass.freeList;
+		sizeClass.freeList = *static_cast<void **>(block);
+		return block;
+	}
+	if (sizeClass.slabUsed + blockSize > SlabBytes) {
+		sizeClass.slab = static_cast<std::byte *>(::operator new(SlabBytes));
+		sizeClass.slabUsed = 0;
+		sizeClass.slabs++;
+	}
+	void *block = sizeClass.slab + sizeClass.slabUsed;
+	sizeClass.slabUsed += blockSize;
+	return block;
+}
+
+// size must be the size the block was allocated with
+inline void Free(void *block, size_t size) {
+	if (!block) return;
+	if (size == 0) size = 1;
+	if (size > MaxBlockSize) {
+		::operator delete(block);
+		return;
+	}
+
+	detail::SizeClass &sizeClass = detail::Classes()[detail::ClassIndex(size)];
+	std::lock_guard<std::mutex> lock(sizeClass.mutex);
+	*static_cast<void **>(block) = sizeClass.freeList;
+	sizeClass.freeList = block;
+	sizeClass.liveBlocks--;
+}
+
+struct Stats {
+	size_t liveBlocks = 0;
+	size_t reservedBytes = 0;
+};
+
+inline Stats GetStats() {
+	Stats stats;
+	for (detail::SizeClass &sizeClass : detail::Classes()) {
+		std::lock_guard<std::mutex> lock(sizeClass.mutex);
+		stats.liveBlocks += sizeClass.liveBlocks;
+		stats.reservedBytes += sizeClass.slabs * SlabBytes;
+	}
+	return stats;
+}
+
+} // namespace BlockPool
+
+#endif
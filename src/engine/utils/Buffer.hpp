@@ -1,6 +1,7 @@
 #ifndef BUFFER_H
 #define BUFFER_H
 
+#include "GLState.hpp"
 #include "glad/glad.h"
 #include <cstddef>
 #include <initializer_list>
@@ -19,7 +20,7 @@ struct Buffer {
 	}
 
 	~Buffer() {
-		glDeleteBuffers(1, &ID);
+		GLState::DeleteBuffer(ID);
 	}
 
 	template <typename T>
@@ -28,9 +29,8 @@ struct Buffer {
 	}
 	template <typename T>
 	void Fill(size_t size, T *data) {
-		glBindBuffer(GL_ARRAY_BUFFER, ID);
+		GLState::BindBuffer(GL_ARRAY_BUFFER, ID);
 		glBufferData(GL_ARRAY_BUFFER, size * sizeof(T), data, GL_DYNAMIC_DRAW);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 	template <typename T>
 	void Fill(T value) {
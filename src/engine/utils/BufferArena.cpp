@@ -0,0 +1,203 @@
+#include "BufferArena.hpp"
+#include "GLState.hpp"
+#include <algorithm>
+#include <imgui.h>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+constexpr size_t Granularity = 16;
+
+size_t AlignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+BufferArena::BufferArena(size_t capacity, size_t streamSegmentBytes) {
+	GLint alignment = 0;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	storageAlignment = std::max<size_t>(Granularity, static_cast<size_t>(alignment));
+
+	generalBytes = AlignUp(capacity, storageAlignment);
+	segmentBytes = AlignUp(streamSegmentBytes, storageAlignment);
+	this->capacity = generalBytes + segmentBytes * StreamSegments;
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &ID);
+	glNamedBufferStorage(ID, this->capacity, nullptr, flags);
+	mapped = static_cast<std::byte *>(glMapNamedBufferRange(ID, 0, this->capacity, flags));
+	if (!mapped) {
+		std::cerr << "ERROR::BUFFER_ARENA: Failed to map " << this->capacity << " bytes" << std::endl;
+		return;
+	}
+	freeBlocks[0] = generalBytes;
+}
+
+BufferArena::~BufferArena() {
+	for (Segment &segment : segments) {
+		if (segment.fence) glDeleteSync(segment.fence);
+	}
+	if (mapped) glUnmapNamedBuffer(ID);
+	GLState::DeleteBuffer(ID);
+}
+
+ArenaAllocation BufferArena::Allocate(size_t size, size_t alignment) {
+	if (size == 0) return {};
+	alignment = alignment == 0 ? storageAlignment : std::max(alignment, Granularity);
+	size = AlignUp(size, Granularity);
+
+	for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it) {
+		size_t blockStart = it->first;
+		size_t blockEnd = it->first + it->second;
+		size_t start = AlignUp(blockStart, alignment);
+		if (start + size > blockEnd) continue;
+
+		freeBlocks.erase(it);
+		if (start > blockStart) {
+			freeBlocks[blockStart] = start - blockStart;
+		}
+		if (start + size < blockEnd) {
+			freeBlocks[start + size] = blockEnd - (start + size);
+		}
+		allocatedBytes += size;
+		allocations++;
+		return {start, size, mapped + start};
+	}
+
+	failedAllocations++;
+	return {};
+}
+
+void BufferArena::Free(ArenaAllocation &allocation) {
+	if (!allocation) return;
+	pendingFrees.push_back({frame, allocation.offset, allocation.size});
+	allocatedBytes -= allocation.size;
+	allocations--;
+	allocation = {};
+}
+
+ArenaAllocation BufferArena::Stream(size_t size, size_t alignment) {
+	if (!mapped || size == 0) return {};
+	alignment = alignment == 0 ? storageAlignment : alignment;
+
+	size_t start = AlignUp(streamHead, alignment);
+	if (start + size > segmentBytes) {
+		streamOverflows++;
+		return {};
+	}
+	streamHead = start + size;
+
+	size_t offset = generalBytes + currentSegment * segmentBytes + start;
+	return {offset, size, mapped + offset};
+}
+
+void BufferArena::EndFrame() {
+	Segment &finished = segments[currentSegment];
+	finished.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	finished.frame = frame;
+	streamLastFrameBytes = streamHead;
+	streamPeakBytes = std::max(streamPeakBytes, streamHead);
+
+	frame++;
+	currentSegment = (currentSegment + 1) % StreamSegments;
+	streamHead = 0;
+
+	// The next segment must be free before anything streams into it. Other
+	// segments are only polled, to release blocks sooner.
+	for (size_t i = 0; i < StreamSegments; i++) {
+		Segment &segment = segments[(currentSegment + i) % StreamSegments];
+		if (!segment.fence) continue;
+
+		GLenum status = glClientWaitSync(segment.fence, 0, 0);
+		if (status == GL_TIMEOUT_EXPIRED) {
+			if (i != 0) continue;
+			fenceWaits++;
+			do {
+				status = glClientWaitSync(segment.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+			} while (status == GL_TIMEOUT_EXPIRED);
+		}
+		glDeleteSync(segment.fence);
+		segment.fence = nullptr;
+		completedFrame = std::max(completedFrame, segment.frame);
+	}
+	ReleaseCompleted();
+}
+
+void BufferArena::BindStorage(unsigned int binding, const ArenaAllocation &allocation) const {
+	GLState::BindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, ID, static_cast<GLintptr>(allocation.offset),
+							 static_cast<GLsizeiptr>(allocation.size));
+}
+
+// Return a block to the free list, merging it with free neighbours
+void BufferArena::Release(size_t offset, size_t size) {
+	auto next = freeBlocks.lower_bound(offset);
+	if (next != freeBlocks.end() && offset + size == next->first) {
+		size += next->second;
+		next = freeBlocks.erase(next);
+	}
+	if (next != freeBlocks.begin()) {
+		auto previous = std::prev(next);
+		if (previous->first + previous->second == offset) {
+			previous->second += size;
+			return;
+		}
+	}
+	freeBlocks[offset] = size;
+}
+
+void BufferArena::ReleaseCompleted() {
+	while (!pendingFrees.empty() && pendingFrees.front().frame <= completedFrame) {
+		Release(pendingFrees.front().offset, pendingFrees.front().size);
+		pendingFrees.pop_front();
+	}
+}
+
+BufferArenaStats BufferArena::GetStats() const {
+	BufferArenaStats stats;
+	stats.capacity = generalBytes;
+	stats.allocatedBytes = allocatedBytes;
+	stats.allocations = allocations;
+	for (const auto &[offset, size] : freeBlocks) {
+		stats.freeBytes += size;
+		stats.largestFreeBlock = std::max(stats.largestFreeBlock, size);
+	}
+	stats.freeBlocks = freeBlocks.size();
+	for (const PendingFree &pending : pendingFrees) {
+		stats.pendingFreeBytes += pending.size;
+	}
+	stats.failedAllocations = failedAllocations;
+	stats.streamSegmentBytes = segmentBytes;
+	stats.streamLastFrameBytes = streamLastFrameBytes;
+	stats.streamPeakBytes = streamPeakBytes;
+	stats.streamOverflows = streamOverflows;
+	stats.fenceWaits = fenceWaits;
+	return stats;
+}
+
+void BufferArena::DrawImGui() const {
+	BufferArenaStats stats = GetStats();
+	const double kib = 1024.0;
+
+	ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+	ImGui::Begin("GPU Arena");
+	ImGui::Text("Allocated: %.1f / %.1f KiB (%zu blocks)", stats.allocatedBytes / kib, stats.capacity / kib,
+				stats.allocations);
+	ImGui::Text("Free: %.1f KiB in %zu blocks, largest %.1f KiB", stats.freeBytes / kib, stats.freeBlocks,
+				stats.largestFreeBlock / kib);
+	ImGui::Text("Fragmentation: %.1f%%", stats.Fragmentation() * 100.0);
+	ImGui::Text("Awaiting GPU: %.1f KiB", stats.pendingFreeBytes / kib);
+	ImGui::Text("Failed Allocations: %zu", stats.failedAllocations);
+	ImGui::Text("Stream: %.1f KiB last frame, peak %.1f / %.1f KiB", stats.streamLastFrameBytes / kib,
+				stats.streamPeakBytes / kib, stats.streamSegmentBytes / kib);
+	ImGui::Text("Stream Overflows: %zu", stats.streamOverflows);
+	ImGui::Text("Fence Waits: %zu", stats.fenceWaits);
+	ImGui::End();
+}
+
+BufferArena &GpuArena() {
+	// Never destroyed; the context is gone by static destruction
+	static BufferArena *arena = new BufferArena(64 * 1024 * 1024, 4 * 1024 * 1024);
+	return *arena;
+}
@@ -0,0 +1,144 @@
+#ifndef BUFFER_ARENA_H
+#define BUFFER_ARENA_H
+
+#include <glad/glad.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <vector>
+
+// A block of the arena's buffer, written through data and read by the GPU at
+// offset
+struct ArenaAllocation {
+	size_t offset = 0;
+	size_t size = 0;
+	std::byte *data = nullptr;
+
+	explicit operator bool() const { return data != nullptr; }
+};
+
+struct BufferArenaStats {
+	size_t capacity = 0;
+	size_t allocatedBytes = 0;
+	size_t allocations = 0;
+	size_t freeBytes = 0;
+	size_t freeBlocks = 0;
+	size_t largestFreeBlock = 0;
+	size_t pendingFreeBytes = 0; // Freed but possibly still read by the GPU
+	size_t failedAllocations = 0;
+
+	size_t streamSegmentBytes = 0;
+	size_t streamLastFrameBytes = 0;
+	size_t streamPeakBytes = 0;
+	size_t streamOverflows = 0;
+	size_t fenceWaits = 0; // Frames that had to wait for the GPU
+
+	// Share of free space unusable for an allocation of the same total size
+	double Fragmentation() const {
+		return freeBytes == 0 ? 0.0 : 1.0 - double(largestFreeBlock) / double(freeBytes);
+	}
+};
+
+// One large GL buffer, persistently and coherently mapped, that geometry is
+// sub-allocated from instead of each user creating buffers of its own. The
+// buffer count stays at one however many chunks, sprites or strings exist.
+//
+// Long lived data takes a block from a first-fit free list; freed blocks are
+// held until the GPU has finished the frames that could read them. Data
+// rewritten every frame is streamed into a ring of segments at the end of
+// the buffer, one segment per frame in flight, each fenced when its frame
+// ends and waited on before it is reused.
+//
+// Blocks are written in place, so an edit can show up in a frame already
+// queued on the GPU. That is only ever a frame early, which is fine for
+// geometry. Main thread only.
+class BufferArena {
+  public:
+	static constexpr size_t StreamSegments = 3;
+
+	unsigned int ID = 0;
+
+	BufferArena(size_t capacity, size_t streamSegmentBytes);
+	~BufferArena();
+	BufferArena(const BufferArena &) = delete;
+	BufferArena &operator=(const BufferArena &) = delete;
+
+	// Alignment 0 uses the storage buffer offset alignment, so any block can
+	// be bound as an SSBO range. Fails with an empty allocation when full.
+	ArenaAllocation Allocate(size_t size, size_t alignment = 0);
+	void Free(ArenaAllocation &allocation);
+
+	// Room for this frame only; the contents are gone once it ends
+	ArenaAllocation Stream(size_t size, size_t alignment = 0);
+	template <typename T>
+	ArenaAllocation Stream(const T *values, size_t count) {
+		ArenaAllocation allocation = Stream(count * sizeof(T));
+		if (allocation && count > 0) {
+			std::memcpy(allocation.data, values, count * sizeof(T));
+		}
+		return allocation;
+	}
+	template <typename T>
+	ArenaAllocation Stream(const std::vector<T> &values) {
+		return Stream(values.data(), values.size());
+	}
+
+	// After the frame's draws are submitted: fence its segment and move to
+	// the next, waiting if the GPU still reads it
+	void EndFrame();
+
+	// Bind a block as a shader storage range
+	void BindStorage(unsigned int binding, const ArenaAllocation &allocation) const;
+
+	// Frames ended so far; streamed blocks are only valid within one
+	uint64_t GetFrame() const { return frame; }
+
+	BufferArenaStats GetStats() const;
+	void DrawImGui() const;
+
+  private:
+	struct PendingFree {
+		uint64_t frame;
+		size_t offset;
+		size_t size;
+	};
+	struct Segment {
+		GLsync fence = nullptr;
+		uint64_t frame = 0;
+	};
+
+	size_t capacity;
+	size_t generalBytes;
+	size_t segmentBytes;
+	size_t storageAlignment;
+	std::byte *mapped = nullptr;
+
+	std::map<size_t, size_t> freeBlocks; // Offset to size, in offset order
+	std::deque<PendingFree> pendingFrees;
+	std::array<Segment, StreamSegments> segments;
+	size_t currentSegment = 0;
+	size_t streamHead = 0;
+
+	uint64_t frame = 0;
+	uint64_t completedFrame = 0; // Every frame up to this one has finished
+
+	size_t allocatedBytes = 0;
+	size_t allocations = 0;
+	size_t failedAllocations = 0;
+	size_t streamLastFrameBytes = 0;
+	size_t streamPeakBytes = 0;
+	size_t streamOverflows = 0;
+	size_t fenceWaits = 0;
+
+	void Release(size_t offset, size_t size);
+	void ReleaseCompleted();
+};
+
+// The arena shared by the renderer, created on first use once a context
+// exists and kept for the life of the program
+BufferArena &GpuArena();
+
+#endif
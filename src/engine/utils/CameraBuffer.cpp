@@ -0,0 +1,48 @@
+#include "CameraBuffer.hpp"
+#include "../Simplex.hpp"
+#include "../ecs/components/Camera.hpp"
+#include "GLState.hpp"
+#include <cstring>
+#include <iostream>
+
+void CameraBuffer::Bind() {
+	BufferArena &arena = GpuArena();
+	if (uploadedFrame != arena.GetFrame()) {
+		uploadedFrame = arena.GetFrame();
+		if (alignment == 0) {
+			GLint offsetAlignment = 0;
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+			alignment = offsetAlignment > 0 ? static_cast<size_t>(offsetAlignment) : 256;
+		}
+		allocation = arena.Stream(sizeof(Block), alignment);
+		if (allocation) {
+			Block block = Current();
+			std::memcpy(allocation.data, &block, sizeof(Block));
+		} else {
+			std::cerr << "ERROR::CAMERA_BUFFER: No stream space for the camera block this frame" << std::endl;
+		}
+	}
+
+	if (!allocation) {
+		GLState::BindBufferBase(GL_UNIFORM_BUFFER, Binding, 0);
+		return;
+	}
+	GLState::BindBufferRange(GL_UNIFORM_BUFFER, Binding, arena.ID, static_cast<GLintptr>(allocation.offset),
+							 static_cast<GLsizeiptr>(allocation.size));
+}
+
+// Identity without a camera, as sprites were drawn before
+CameraBuffer::Block CameraBuffer::Current() {
+	Block block = {glm::mat4(1.0f), glm::mat4(1.0f)};
+	Entity *camera = Simplex::view.GetCamera();
+	if (Camera *component = camera ? camera->GetComponent<Camera>() : nullptr) {
+		block.worldProjection = component->CalculateWorldSpaceProjection();
+		block.screenProjection = component->CalcualteScreenSpaceProjection();
+	}
+	return block;
+}
+
+CameraBuffer &Cameras() {
+	static CameraBuffer buffer;
+	return buffer;
+}
@@ -0,0 +1,41 @@
+#ifndef CAMERA_BUFFER_H
+#define CAMERA_BUFFER_H
+
+#include "BufferArena.hpp"
+#include <glad/glad.h>
+#include <cstdint>
+#include <glm/ext/matrix_float4x4.hpp>
+
+// The camera's projections as a std140 uniform block, matching CameraBlock
+// in the shaders, so draws share one upload instead of each setting its own
+// matrix. Shader binds any block named CameraBlock to Binding when linking.
+//
+// The block is computed and streamed through the GPU arena on the first Bind
+// of a frame; later Binds that frame only rebind the same range, so a camera
+// moving mid-frame shows from the next one. Main thread only.
+class CameraBuffer {
+  public:
+	static constexpr GLuint Binding = 0;
+
+	// std140 lays two mat4s out back to back, as here
+	struct Block {
+		glm::mat4 worldProjection;
+		glm::mat4 screenProjection;
+	};
+
+	// Upload the block once a frame and bind it for the next draws. If the
+	// arena has no room the binding is cleared for the frame rather than
+	// left on last frame's block, which may already be overwritten.
+	void Bind();
+
+  private:
+	ArenaAllocation allocation; // Empty if this frame's Stream failed
+	uint64_t uploadedFrame = UINT64_MAX;
+	size_t alignment = 0;
+
+	static Block Current();
+};
+
+CameraBuffer &Cameras();
+
+#endif
@@ -0,0 +1,394 @@
+#ifndef CHUNK_BATCH_H
+#define CHUNK_BATCH_H
+
+#include "../ecs/components/Camera.hpp"
+#include "../ResourceManager.hpp"
+#include "../Simplex.hpp"
+#include "BufferArena.hpp"
+#include "CameraBuffer.hpp"
+#include "GLState.hpp"
+#include "Shader.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <glad/glad.h>
+#include <glm/ext/vector_int2.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Layout glMultiDrawArraysIndirect reads commands in
+struct DrawArraysIndirectCommand {
+	GLuint count;
+	GLuint instanceCount;
+	GLuint first;
+	GLuint baseInstance;
+};
+
+// Tiles of every chunk in the GPU arena, drawn with a single multi-draw.
+// Each chunk's region holds a block of regionTiles words, one packed tile per
+// word. Per region the arena also holds the chunk's origin and where its
+// tiles start and how many are drawn.
+//
+// DrawVisible leaves culling to the GPU: a compute pass tests every region
+// against the camera and writes a compacted command for each one in view,
+// and a single indirect draw consumes them, so the CPU does the same work
+// however many chunks are resident. Queue and Draw instead submit the chunks
+// the caller picked, for maps that cull on the CPU.
+//
+// Each command's base instance is its region, read back through an
+// instanced attribute rather than gl_BaseInstance, which needs GL 4.6.
+//
+// A region also has a slice of an integer texture holding its tile types.
+// In tilemap mode each chunk is drawn as one quad that looks its tiles up in
+// that slice instead, six vertices a chunk rather than six a tile.
+//
+// Zoomed far out, tiles are only a few pixels, so chunks are drawn as one
+// quad of a small baked colour texture, a slice of the LOD atlas per region.
+// Between lodStartZoom and lodFullZoom the LOD quads fade in over the tiles,
+// and below it the tiles aren't drawn at all.
+class ChunkBatch {
+  public:
+	struct Shaders {
+		std::string tiles;
+		std::string tilemap;
+		std::string lod;
+		std::string cull;
+	};
+
+	// Draw chunks as one quad each rather than one per tile
+	bool tilemap = false;
+	// Camera zoom, in pixels per tile, where the LOD starts to show and
+	// where it has replaced the tiles
+	float lodStartZoom = 10.0f;
+	float lodFullZoom = 6.0f;
+
+	ChunkBatch(int chunkSize, int lodSize, Shaders shaders, std::string textures)
+		: chunkSize(chunkSize), lodSize(lodSize), regionTiles(size_t(chunkSize) * chunkSize),
+		  shaders(std::move(shaders)), texturesName(std::move(textures)) {
+		glCreateVertexArrays(1, &vao);
+		glEnableVertexArrayAttrib(vao, RegionAttribute);
+		glVertexArrayAttribIFormat(vao, RegionAttribute, 1, GL_UNSIGNED_INT, 0);
+		glVertexArrayAttribBinding(vao, RegionAttribute, 0);
+		glVertexArrayBindingDivisor(vao, 0, 1);
+	}
+	~ChunkBatch() {
+		GLState::DeleteVertexArray(vao);
+		GLState::DeleteTexture(tileTypes);
+		GLState::DeleteTexture(lodColours);
+	}
+	ChunkBatch(const ChunkBatch &) = delete;
+	ChunkBatch &operator=(const ChunkBatch &) = delete;
+
+	uint32_t Allocate() {
+		uint32_t region;
+		if (!freeRegions.empty()) {
+			region = freeRegions.back();
+			freeRegions.pop_back();
+		} else {
+			region = static_cast<uint32_t>(tileCounts.size());
+			tileCounts.push_back(0);
+			tileBlocks.emplace_back();
+			// Double the per-region storage once every region is taken
+			if (tileCounts.size() > regionCapacity) {
+				Reserve(std::max<size_t>(tileCounts.size() * 2, 64));
+			}
+		}
+		// A chunk that doesn't fit in the arena is never drawn
+		if (region < regionCapacity) {
+			tileBlocks[region] = GpuArena().Allocate(regionTiles * sizeof(unsigned int));
+		}
+		SetTileCount(region, 0);
+		return region;
+	}
+
+	// The tile block goes back to the arena once frames drawing it are done
+	void Free(uint32_t region) {
+		GpuArena().Free(tileBlocks[region]);
+		SetTileCount(region, 0);
+		freeRegions.push_back(region);
+	}
+
+	void SetOrigin(uint32_t region, glm::ivec2 origin) {
+		if (region >= regionCapacity) return;
+		std::memcpy(originBlock.data + region * sizeof(glm::ivec2), &origin, sizeof(glm::ivec2));
+	}
+
+	// Overwrite tiles starting at first; they must fit in the region
+	void SetTiles(uint32_t region, size_t first, const std::vector<unsigned int> &values) {
+		if (values.empty() || !tileBlocks[region]) return;
+		std::memcpy(tileBlocks[region].data + first * sizeof(unsigned int), values.data(),
+					values.size() * sizeof(unsigned int));
+	}
+
+	// Tile types in tile index order, one byte per tile of the chunk
+	void SetTileTypes(uint32_t region, const uint8_t *types) {
+		if (region >= regionCapacity) return;
+		glTextureSubImage3D(tileTypes, 0, 0, 0, region, chunkSize, chunkSize, 1, GL_RED_INTEGER, GL_UNSIGNED_BYTE,
+							types);
+	}
+
+	// RGBA colours of the chunk's LOD, lodSize rows of lodSize from the
+	// bottom left
+	void SetLodColours(uint32_t region, const uint8_t *colours) {
+		if (region >= regionCapacity) return;
+		glTextureSubImage3D(lodColours, 0, 0, 0, region, lodSize, lodSize, 1, GL_RGBA, GL_UNSIGNED_BYTE, colours);
+	}
+
+	// How many tiles from the start of the region are drawn
+	void SetTileCount(uint32_t region, size_t count) {
+		tileCounts[region] = tileBlocks[region] ? static_cast<uint32_t>(std::min(count, regionTiles)) : 0;
+		if (region >= regionCapacity) return;
+		uint32_t draw[2] = {FirstWord(region), tileCounts[region]};
+		std::memcpy(drawBlock.data + region * sizeof(draw), draw, sizeof(draw));
+	}
+
+	void Queue(uint32_t region) {
+		if (tileCounts[region] == 0) return;
+		queued.push_back(region);
+	}
+
+	// One draw per pass for everything queued since the last call
+	void Draw() {
+		lastDrawCount = queued.size();
+		ForEachPass([&](Pass pass, float alpha) {
+			std::vector<DrawArraysIndirectCommand> commands;
+			commands.reserve(queued.size());
+			for (uint32_t region : queued) {
+				if (pass == Pass::Tiles) {
+					commands.push_back({tileCounts[region] * 6, 1, FirstWord(region) * 6, region});
+				} else {
+					commands.push_back({6, 1, 0, region});
+				}
+			}
+			DrawQueued(pass, alpha, commands);
+		});
+		queued.clear();
+	}
+
+	// Cull every region on the GPU and draw the ones in view. Without a
+	// camera there is no view to cull against, so nothing is drawn.
+	void DrawVisible() {
+		Camera *camera = ViewCamera();
+		lastDrawCount = camera ? tileCounts.size() : 0;
+		if (!camera) return;
+		glm::vec4 viewRect = ViewRect(*camera);
+		ForEachPass([&](Pass pass, float alpha) { CullAndDraw(pass, alpha, viewRect); });
+	}
+
+	// How far the LOD has replaced the tiles at the current zoom, 0 to 1.
+	// Tiles only while there is no camera.
+	float LodBlend() const {
+		Camera *camera = ViewCamera();
+		if (!camera) return 0.0f;
+		float zoom = camera->zoom;
+		float t = std::clamp((lodStartZoom - zoom) / std::max(lodStartZoom - lodFullZoom, 0.001f), 0.0f, 1.0f);
+		return t * t * (3.0f - 2.0f * t);
+	}
+
+	size_t GetRegionCount() const { return tileCounts.size() - freeRegions.size(); }
+	// Chunks submitted by the last Draw, or regions tested by DrawVisible
+	size_t GetLastDrawCount() const { return lastDrawCount; }
+	size_t GetRegionBytes() const {
+		return regionTiles * (sizeof(unsigned int) + sizeof(uint8_t)) + size_t(lodSize) * lodSize * 4 +
+			   sizeof(glm::ivec2) + 3 * sizeof(uint32_t);
+	}
+
+  private:
+	enum class Pass { Tiles, Tilemap, Lod };
+
+	static constexpr GLuint RegionAttribute = 0;
+	static constexpr size_t CullGroupSize = 64;
+
+	int chunkSize;
+	int lodSize;
+	size_t regionTiles;
+	Shaders shaders;
+	std::string texturesName;
+	unsigned int vao;
+
+	std::vector<ArenaAllocation> tileBlocks; // Per region
+	// Per region: origin, first tile word and count, and the region's own
+	// index for the instanced attribute
+	ArenaAllocation originBlock;
+	ArenaAllocation drawBlock;
+	ArenaAllocation regionIdBlock;
+	size_t regionCapacity = 0;
+	// GL_R8UI array with a chunkSize square slice per region
+	unsigned int tileTypes = 0;
+	// The LOD atlas, a lodSize square GL_RGBA8 slice per region
+	unsigned int lodColours = 0;
+	std::vector<uint32_t> tileCounts; // Drawn tiles per region
+	std::vector<uint32_t> freeRegions;
+	std::vector<uint32_t> queued;
+	size_t lastDrawCount = 0;
+
+	// Tiles until the LOD is fully in, then the LOD over them as it fades in
+	template <typename Fn>
+	void ForEachPass(Fn &&fn) {
+		float blend = LodBlend();
+		if (blend < 1.0f) {
+			fn(tilemap ? Pass::Tilemap : Pass::Tiles, 1.0f);
+		}
+		if (blend > 0.0f) {
+			fn(Pass::Lod, blend);
+		}
+	}
+
+	void DrawQueued(Pass pass, float alpha, const std::vector<DrawArraysIndirectCommand> &queuedCommands) {
+		if (queuedCommands.empty()) return;
+		BufferArena &arena = GpuArena();
+		ArenaAllocation commands = arena.Stream(queuedCommands);
+		if (!commands) return;
+
+		BeginDraw(pass, alpha);
+		glMultiDrawArraysIndirect(GL_TRIANGLES, reinterpret_cast<const void *>(commands.offset),
+								  static_cast<GLsizei>(queuedCommands.size()), 0);
+	}
+
+	void CullAndDraw(Pass pass, float alpha, const glm::vec4 &viewRect) {
+		size_t regions = tileCounts.size();
+		if (regions == 0 || regionCapacity == 0) return;
+
+		// Commands and their count are written by the cull pass, into this
+		// frame's stream so the ring's fences cover them
+		BufferArena &arena = GpuArena();
+		ArenaAllocation commands = arena.Stream(regions * sizeof(DrawArraysIndirectCommand));
+		const uint32_t zero = 0;
+		ArenaAllocation drawCount = arena.Stream(&zero, 1);
+		if (!commands || !drawCount) return;
+
+		// Without indirect count every region's command is drawn, so the
+		// ones past the visible chunks have to be empty
+		bool indirectCount = GLAD_GL_VERSION_4_6;
+		if (!indirectCount) {
+			glClearNamedBufferSubData(arena.ID, GL_R32UI, commands.offset, commands.size, GL_RED_INTEGER,
+									  GL_UNSIGNED_INT, &zero);
+		}
+
+		Shader cull = ResourceManager::GetShader(shaders.cull);
+		cull.use();
+		cull.setUInt("regionCount", static_cast<unsigned int>(regions));
+		cull.setInt("chunkSize", chunkSize);
+		cull.setBool("quads", pass != Pass::Tiles);
+		cull.setVec4("viewRect", viewRect);
+		arena.BindStorage(1, originBlock);
+		arena.BindStorage(3, drawBlock);
+		arena.BindStorage(4, commands);
+		arena.BindStorage(5, drawCount);
+		glDispatchCompute(static_cast<GLuint>((regions + CullGroupSize - 1) / CullGroupSize), 1, 1);
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+		BeginDraw(pass, alpha);
+		if (indirectCount) {
+			GLState::BindBuffer(GL_PARAMETER_BUFFER, arena.ID);
+			glMultiDrawArraysIndirectCount(GL_TRIANGLES, reinterpret_cast<const void *>(commands.offset),
+										   static_cast<GLintptr>(drawCount.offset), static_cast<GLsizei>(regions), 0);
+		} else {
+			glMultiDrawArraysIndirect(GL_TRIANGLES, reinterpret_cast<const void *>(commands.offset),
+									  static_cast<GLsizei>(regions), 0);
+		}
+	}
+
+	uint32_t FirstWord(uint32_t region) const {
+		return static_cast<uint32_t>(tileBlocks[region].offset / sizeof(unsigned int));
+	}
+
+	// Blocks can't grow in place, so the per-region data moves to bigger ones.
+	// Nothing changes unless all of them fit.
+	void Reserve(size_t regions) {
+		BufferArena &arena = GpuArena();
+		ArenaAllocation origins = arena.Allocate(regions * sizeof(glm::ivec2));
+		ArenaAllocation draws = arena.Allocate(regions * 2 * sizeof(uint32_t));
+		ArenaAllocation regionIds = arena.Allocate(regions * sizeof(uint32_t));
+		if (!origins || !draws || !regionIds) {
+			arena.Free(origins);
+			arena.Free(draws);
+			arena.Free(regionIds);
+			return;
+		}
+
+		std::memset(origins.data, 0, origins.size);
+		std::memset(draws.data, 0, draws.size);
+		if (regionCapacity > 0) {
+			std::memcpy(origins.data, originBlock.data, regionCapacity * sizeof(glm::ivec2));
+			std::memcpy(draws.data, drawBlock.data, regionCapacity * 2 * sizeof(uint32_t));
+		}
+		for (size_t region = 0; region < regions; region++) {
+			uint32_t id = static_cast<uint32_t>(region);
+			std::memcpy(regionIds.data + region * sizeof(uint32_t), &id, sizeof(id));
+		}
+		arena.Free(originBlock);
+		arena.Free(drawBlock);
+		arena.Free(regionIdBlock);
+		originBlock = origins;
+		drawBlock = draws;
+		regionIdBlock = regionIds;
+		glVertexArrayVertexBuffer(vao, 0, arena.ID, static_cast<GLintptr>(regionIdBlock.offset), sizeof(uint32_t));
+
+		GrowSlices(tileTypes, GL_R8UI, chunkSize, GL_NEAREST, regions);
+		GrowSlices(lodColours, GL_RGBA8, lodSize, GL_LINEAR, regions);
+		regionCapacity = regions;
+	}
+
+	// Texture storage is immutable, so growing copies into a new array
+	void GrowSlices(unsigned int &texture, GLenum format, int size, GLint filter, size_t slices) {
+		unsigned int grown;
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &grown);
+		glTextureStorage3D(grown, 1, format, size, size, static_cast<GLsizei>(slices));
+		glTextureParameteri(grown, GL_TEXTURE_MIN_FILTER, filter);
+		glTextureParameteri(grown, GL_TEXTURE_MAG_FILTER, filter);
+		glTextureParameteri(grown, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(grown, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		if (regionCapacity > 0) {
+			glCopyImageSubData(texture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, grown, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, size,
+							   size, static_cast<GLsizei>(regionCapacity));
+			GLState::DeleteTexture(texture);
+		}
+		texture = grown;
+	}
+
+	// World tiles the camera sees, as left, bottom, right, top. The bounds'
+	// sides are named for screen space, so sort them rather than trust them.
+	static glm::vec4 ViewRect(Camera &camera) {
+		RectBounds<float> bounds = camera.GetCameraBounds();
+		return glm::vec4(std::min(bounds.left, bounds.right), std::min(bounds.top, bounds.bottom),
+						 std::max(bounds.left, bounds.right), std::max(bounds.top, bounds.bottom));
+	}
+
+	// nullptr before the camera entity exists or once it is destroyed
+	static Camera *ViewCamera() {
+		Entity *entity = Simplex::view.GetCamera();
+		return entity ? entity->GetComponent<Camera>() : nullptr;
+	}
+
+	// State shared by every pass's draw. Bindings are left in place for the
+	// next draw; the state cache skips the ones that don't change.
+	void BeginDraw(Pass pass, float alpha) {
+		const std::string &name = pass == Pass::Tiles	  ? shaders.tiles
+								  : pass == Pass::Tilemap ? shaders.tilemap
+														  : shaders.lod;
+		Shader shader = ResourceManager::GetShader(name);
+		shader.use();
+		Cameras().Bind();
+		shader.setInt("chunkSize", chunkSize);
+		shader.setInt("tileTextures", 0);
+		shader.setInt("tileTypes", 1);
+		shader.setInt("lodColours", 2);
+		shader.setFloat("lodAlpha", alpha);
+
+		BufferArena &arena = GpuArena();
+		GLState::BindTextureUnit(0, ResourceManager::GetTextureArray(texturesName).ID);
+		GLState::BindTextureUnit(1, tileTypes);
+		GLState::BindTextureUnit(2, lodColours);
+		// Tiles are read by their word in the whole arena
+		GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, arena.ID);
+		arena.BindStorage(1, originBlock);
+		GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, arena.ID);
+		GLState::BindVertexArray(vao);
+	}
+};
+
+#endif
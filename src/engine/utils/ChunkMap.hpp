@@ -0,0 +1,328 @@
+#ifndef CHUNK_MAP_H
+#define CHUNK_MAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <glm/ext/vector_int2.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CHUNK_MAP_SSE2 1
+#endif
+
+// Interleave the bits of a chunk coordinate so chunks that are close in
+// space get close keys. Coordinates are offset to unsigned first.
+inline uint64_t MortonEncode(const glm::ivec2 &coord) {
+	auto spread = [](uint32_t value) {
+		uint64_t v = value;
+		v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+		v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+		v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+		v = (v | (v << 2)) & 0x3333333333333333ull;
+		v = (v | (v << 1)) & 0x5555555555555555ull;
+		return v;
+	};
+	return spread(static_cast<uint32_t>(coord.x) ^ 0x80000000u) |
+		   (spread(static_cast<uint32_t>(coord.y) ^ 0x80000000u) << 1);
+}
+
+// Flat hash map from chunk coordinate to V. Slots live in one array with a
+// parallel array of control bytes holding 7 bits of each key's hash, so a
+// lookup compares 16 candidates at once (SSE2, with a scalar fallback) before
+// touching any keys. Probing is linear and erase shifts the rest of the probe
+// run back, so there are no tombstones and lookups never slow down with churn.
+//
+// Erasing moves other entries; pointers and iterators to entries other than
+// the one returned by erase(iterator) are invalidated by erase and insert.
+template <typename V>
+class ChunkMap {
+  public:
+	struct Slot {
+		glm::ivec2 first;
+		V second;
+	};
+
+	template <bool Const>
+	class Iterator {
+		using MapPtr = std::conditional_t<Const, const ChunkMap *, ChunkMap *>;
+		using SlotRef = std::conditional_t<Const, const Slot &, Slot &>;
+
+	  public:
+		Iterator(MapPtr map, size_t index) : map(map), index(index) { SkipEmpty(); }
+
+		SlotRef operator*() const { return map->slots[index]; }
+		auto operator->() const { return &map->slots[index]; }
+		Iterator &operator++() {
+			index++;
+			SkipEmpty();
+			return *this;
+		}
+		bool operator==(const Iterator &other) const { return index == other.index; }
+		bool operator!=(const Iterator &other) const { return index != other.index; }
+
+	  private:
+		friend class ChunkMap;
+		MapPtr map;
+		size_t index;
+
+		void SkipEmpty() {
+			while (index < map->capacity && map->control[index] == Empty) {
+				index++;
+			}
+		}
+	};
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	ChunkMap() { Rehash(MinCapacity); }
+
+	ChunkMap(const ChunkMap &) = default;
+	ChunkMap &operator=(const ChunkMap &) = default;
+	ChunkMap(ChunkMap &&) = default;
+	ChunkMap &operator=(ChunkMap &&) = default;
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, capacity); }
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, capacity); }
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	iterator find(const glm::ivec2 &key) {
+		size_t index = FindIndex(key);
+		return iterator(this, index == NotFound ? capacity : index);
+	}
+
+	bool contains(const glm::ivec2 &key) const { return FindIndex(key) != NotFound; }
+
+	// Value for key, or nullptr
+	V *Find(const glm::ivec2 &key) {
+		size_t index = FindIndex(key);
+		return index == NotFound ? nullptr : &slots[index].second;
+	}
+	const V *Find(const glm::ivec2 &key) const {
+		size_t index = FindIndex(key);
+		return index == NotFound ? nullptr : &slots[index].second;
+	}
+
+	V &operator[](const glm::ivec2 &key) { return insert(key, V{}).first->second; }
+
+	// Insert if absent. Returns the entry and whether it was inserted.
+	std::pair<iterator, bool> insert(const glm::ivec2 &key, V value) {
+		size_t index = FindIndex(key);
+		if (index != NotFound) {
+			return {iterator(this, index), false};
+		}
+
+		if ((count + 1) * 4 > capacity * 3) {
+			Rehash(capacity * 2);
+		}
+		uint64_t hash = Hash(key);
+		index = FindEmpty(hash);
+		SetControl(index, static_cast<uint8_t>(hash & 0x7F));
+		slots[index].first = key;
+		slots[index].second = std::move(value);
+		count++;
+		return {iterator(this, index), true};
+	}
+
+	size_t erase(const glm::ivec2 &key) {
+		size_t index = FindIndex(key);
+		if (index == NotFound) return 0;
+		EraseIndex(index);
+		return 1;
+	}
+
+	// Returns an iterator to the next entry to visit. Because the erased
+	// slot may be refilled from later in its probe run, that is often the
+	// same position.
+	iterator erase(iterator it) {
+		EraseIndex(it.index);
+		return iterator(this, it.index);
+	}
+
+	void clear() {
+		std::fill(control.begin(), control.end(), Empty);
+		for (auto &slot : slots) {
+			slot.second = V{};
+		}
+		count = 0;
+	}
+
+	void reserve(size_t entries) {
+		size_t wanted = MinCapacity;
+		while (wanted * 3 < entries * 4) {
+			wanted *= 2;
+		}
+		if (wanted > capacity) {
+			Rehash(wanted);
+		}
+	}
+
+  private:
+	static constexpr uint8_t Empty = 0x80;
+	static constexpr size_t GroupSize = 16;
+	static constexpr size_t MinCapacity = 16;
+	static constexpr size_t NotFound = ~size_t(0);
+
+	// capacity + GroupSize control bytes; the tail mirrors the first group so
+	// a group load never needs to wrap
+	std::vector<uint8_t> control;
+	std::vector<Slot> slots;
+	size_t capacity = 0;
+	size_t count = 0;
+
+	static uint64_t Hash(const glm::ivec2 &key) {
+		// Morton keys of neighbouring chunks differ in only a few low bits;
+		// a multiply and fold spreads them over the whole table
+		uint64_t h = MortonEncode(key) * 0x9E3779B97F4A7C15ull;
+		return h ^ (h >> 32);
+	}
+
+	size_t Home(uint64_t hash) const { return (hash >> 7) & (capacity - 1); }
+
+	void SetControl(size_t index, uint8_t value) {
+		control[index] = value;
+		if (index < GroupSize) {
+			control[capacity + index] = value;
+		}
+	}
+
+	// Bit i set where control byte i of the group equals value
+	static uint32_t MatchByte(const uint8_t *group, uint8_t value) {
+#ifdef CHUNK_MAP_SSE2
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(value)))));
+#else
+		uint32_t mask = 0;
+		for (size_t i = 0; i < GroupSize; i++) {
+			mask |= static_cast<uint32_t>(group[i] == value) << i;
+		}
+		return mask;
+#endif
+	}
+
+	static uint32_t MatchEmpty(const uint8_t *group) {
+#ifdef CHUNK_MAP_SSE2
+		// Empty is the only control value with the high bit set
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(group))));
+#else
+		return MatchByte(group, Empty);
+#endif
+	}
+
+	static int LowestBit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctz(mask);
+#else
+		int bit = 0;
+		while (!(mask & 1)) {
+			mask >>= 1;
+			bit++;
+		}
+		return bit;
+#endif
+	}
+
+	size_t FindIndex(const glm::ivec2 &key) const {
+		uint64_t hash = Hash(key);
+		uint8_t tag = static_cast<uint8_t>(hash & 0x7F);
+		size_t position = Home(hash);
+
+		while (true) {
+			const uint8_t *group = control.data() + position;
+			for (uint32_t match = MatchByte(group, tag); match; match &= match - 1) {
+				size_t index = (position + LowestBit(match)) & (capacity - 1);
+				if (slots[index].first == key) {
+					return index;
+				}
+			}
+			// A key is always stored before the first empty slot of its run
+			if (MatchEmpty(group)) {
+				return NotFound;
+			}
+			position = (position + GroupSize) & (capacity - 1);
+		}
+	}
+
+	size_t FindEmpty(uint64_t hash) const {
+		size_t position = Home(hash);
+		while (true) {
+			uint32_t empty = MatchEmpty(control.data() + position);
+			if (empty) {
+				return (position + LowestBit(empty)) & (capacity - 1);
+			}
+			position = (position + GroupSize) & (capacity - 1);
+		}
+	}
+
+	// Backward-shift deletion: pull later entries of the probe run into the
+	// hole unless that would move them before their home slot
+	void EraseIndex(size_t hole) {
+		size_t mask = capacity - 1;
+		size_t next = hole;
+		while (true) {
+			next = (next + 1) & mask;
+			if (control[next] == Empty) break;
+
+			size_t home = Home(Hash(slots[next].first));
+			bool homeInRange = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+			if (homeInRange) continue;
+
+			SetControl(hole, control[next]);
+			slots[hole] = std::move(slots[next]);
+			hole = next;
+		}
+		SetControl(hole, Empty);
+		slots[hole].second = V{};
+		count--;
+	}
+
+	void Rehash(size_t newCapacity) {
+		std::vector<uint8_t> oldControl = std::move(control);
+		std::vector<Slot> oldSlots = std::move(slots);
+		size_t oldCapacity = capacity;
+
+		capacity = newCapacity;
+		control.assign(capacity + GroupSize, Empty);
+		slots.assign(capacity, Slot{glm::ivec2(0, 0), V{}});
+		count = 0;
+
+		for (size_t i = 0; i < oldCapacity; i++) {
+			if (oldControl[i] == Empty) continue;
+			uint64_t hash = Hash(oldSlots[i].first);
+			size_t index = FindEmpty(hash);
+			SetControl(index, static_cast<uint8_t>(hash & 0x7F));
+			slots[index] = std::move(oldSlots[i]);
+			count++;
+		}
+	}
+};
+
+// Set of chunk coordinates on top of ChunkMap
+class ChunkSet {
+  public:
+	bool insert(const glm::ivec2 &key) { return map.insert(key, true).second; }
+	size_t erase(const glm::ivec2 &key) { return map.erase(key); }
+	bool contains(const glm::ivec2 &key) const { return map.contains(key); }
+	size_t size() const { return map.size(); }
+	bool empty() const { return map.empty(); }
+	void clear() { map.clear(); }
+
+	template <typename Fn>
+	void ForEach(Fn fn) {
+		for (auto &[key, present] : map) {
+			fn(key);
+		}
+	}
+
+  private:
+	ChunkMap<bool> map;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef COW_PTR_H
+#define COW_PTR_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Copy-on-write ownership of a value. A snapshot shares the current version;
+// the owner copies the value before its next write while any snapshot still
+// holds it, so a snapshot never changes under its reader. Snapshot and Write
+// belong to the owning thread; snapshots can be read and released anywhere.
+template <typename T>
+class CowPtr {
+  public:
+	CowPtr() : value(std::make_shared<T>()) {}
+	CowPtr(T initial) : value(std::make_shared<T>(std::move(initial))) {}
+
+	CowPtr &operator=(T replacement) {
+		value = std::make_shared<T>(std::move(replacement));
+		return *this;
+	}
+
+	const T &operator*() const { return *value; }
+	const T *operator->() const { return value.get(); }
+
+	std::shared_ptr<const T> Snapshot() const { return value; }
+
+	// Mutable access, copying first if a snapshot shares this version
+	T &Write() {
+		if (value.use_count() > 1) {
+			value = std::make_shared<T>(*value);
+			copies++;
+		} else {
+			// Pairs with the release when the last reader dropped its
+			// snapshot, so its reads happen before our writes
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+		return *value;
+	}
+
+	bool IsShared() const { return value.use_count() > 1; }
+
+	// Writes that had to copy, over this owner's lifetime
+	size_t GetCopyCount() const { return copies; }
+
+  private:
+	std::shared_ptr<T> value;
+	size_t copies = 0;
+};
+
+#endif
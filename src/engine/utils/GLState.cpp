@@ -0,0 +1,160 @@
+#include "GLState.hpp"
+#include <array>
+#include <imgui.h>
+
+namespace {
+
+// No name GL hands out, so an unknown binding never matches
+constexpr GLuint Unknown = ~0u;
+constexpr size_t TextureUnits = 32;
+constexpr size_t IndexedBindings = 16;
+
+struct IndexedBinding {
+	GLuint buffer = Unknown;
+	GLintptr offset = 0;
+	GLsizeiptr size = 0; // -1 for the whole buffer
+
+	bool operator==(const IndexedBinding &) const = default;
+};
+
+struct TargetBinding {
+	GLenum target;
+	GLuint buffer = Unknown;
+};
+
+struct IndexedTarget {
+	GLenum target;
+	std::array<IndexedBinding, IndexedBindings> bindings;
+};
+
+struct Cache {
+	GLuint program = Unknown;
+	GLuint vao = Unknown;
+	std::array<GLuint, TextureUnits> textures;
+	// Binding points outside vertex array state
+	std::array<TargetBinding, 5> targets = {{{GL_ARRAY_BUFFER},
+											 {GL_DRAW_INDIRECT_BUFFER},
+											 {GL_PARAMETER_BUFFER},
+											 {GL_SHADER_STORAGE_BUFFER},
+											 {GL_UNIFORM_BUFFER}}};
+	std::array<IndexedTarget, 2> indexed = {{{GL_SHADER_STORAGE_BUFFER, {}}, {GL_UNIFORM_BUFFER, {}}}};
+
+	Cache() { textures.fill(Unknown); }
+};
+
+Cache cache;
+GLStateStats stats;
+
+GLuint *TargetSlot(GLenum target) {
+	for (TargetBinding &binding : cache.targets) {
+		if (binding.target == target) return &binding.buffer;
+	}
+	return nullptr;
+}
+
+IndexedBinding *IndexedSlot(GLenum target, GLuint index) {
+	if (index >= IndexedBindings) return nullptr;
+	for (IndexedTarget &indexed : cache.indexed) {
+		if (indexed.target == target) return &indexed.bindings[index];
+	}
+	return nullptr;
+}
+
+// True when the bind has to reach GL, recording value as the new state
+template <typename T>
+bool Changes(T *slot, const T &value) {
+	if (slot && *slot == value) {
+		stats.skipped++;
+		return false;
+	}
+	if (slot) *slot = value;
+	stats.issued++;
+	return true;
+}
+
+// Indexed binds also set the target's generic binding point
+bool ChangesIndexed(GLenum target, GLuint index, IndexedBinding binding) {
+	if (!Changes(IndexedSlot(target, index), binding)) return false;
+	if (GLuint *generic = TargetSlot(target)) *generic = binding.buffer;
+	return true;
+}
+
+} // namespace
+
+namespace GLState {
+
+void UseProgram(GLuint program) {
+	if (Changes(&cache.program, program)) glUseProgram(program);
+}
+
+void BindVertexArray(GLuint vao) {
+	if (Changes(&cache.vao, vao)) glBindVertexArray(vao);
+}
+
+void BindTextureUnit(GLuint unit, GLuint texture) {
+	GLuint *slot = unit < TextureUnits ? &cache.textures[unit] : nullptr;
+	if (Changes(slot, texture)) glBindTextureUnit(unit, texture);
+}
+
+void BindBuffer(GLenum target, GLuint buffer) {
+	if (Changes(TargetSlot(target), buffer)) glBindBuffer(target, buffer);
+}
+
+void BindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+	if (ChangesIndexed(target, index, {buffer, 0, -1})) glBindBufferBase(target, index, buffer);
+}
+
+void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+	if (ChangesIndexed(target, index, {buffer, offset, size})) glBindBufferRange(target, index, buffer, offset, size);
+}
+
+void DeleteTexture(GLuint &texture) {
+	for (GLuint &bound : cache.textures) {
+		if (bound == texture) bound = Unknown;
+	}
+	glDeleteTextures(1, &texture);
+	texture = 0;
+}
+
+void DeleteBuffer(GLuint &buffer) {
+	for (TargetBinding &binding : cache.targets) {
+		if (binding.buffer == buffer) binding.buffer = Unknown;
+	}
+	for (IndexedTarget &indexed : cache.indexed) {
+		for (IndexedBinding &binding : indexed.bindings) {
+			if (binding.buffer == buffer) binding = {};
+		}
+	}
+	glDeleteBuffers(1, &buffer);
+	buffer = 0;
+}
+
+void DeleteVertexArray(GLuint &vao) {
+	if (cache.vao == vao) cache.vao = Unknown;
+	glDeleteVertexArrays(1, &vao);
+	vao = 0;
+}
+
+void Invalidate() {
+	cache = Cache();
+}
+
+// Anything outside the cache may have bound in between frames
+void BeginFrame() {
+	Invalidate();
+	stats = {};
+}
+
+GLStateStats GetStats() {
+	return stats;
+}
+
+void DrawImGui() {
+	ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+	ImGui::Begin("GL State");
+	ImGui::Text("Binds Issued: %zu", stats.issued);
+	ImGui::Text("Binds Skipped: %zu", stats.skipped);
+	ImGui::End();
+}
+
+} // namespace GLState
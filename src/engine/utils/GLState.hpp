@@ -0,0 +1,45 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+#include <cstddef>
+
+struct GLStateStats {
+	size_t issued = 0;	// Binds passed on to GL this frame
+	size_t skipped = 0; // Binds dropped because nothing would change
+};
+
+// Remembers the program, vertex array, texture units and buffer bindings last
+// set through it, and skips binds that wouldn't change them. Each one still
+// costs a driver call otherwise, which adds up over thousands of draws.
+//
+// The cache only knows about binds made through it. Code that binds through
+// GL directly, or deletes an object that may be bound, must go through the
+// Delete functions or call Invalidate. Element array bindings belong to the
+// vertex array, so they aren't cached. Main thread only.
+namespace GLState {
+
+void UseProgram(GLuint program);
+void BindVertexArray(GLuint vao);
+// Binds to whatever target the texture was created with
+void BindTextureUnit(GLuint unit, GLuint texture);
+void BindBuffer(GLenum target, GLuint buffer);
+void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+// Deleting unbinds the object, and GL may hand its name out again
+void DeleteTexture(GLuint &texture);
+void DeleteBuffer(GLuint &buffer);
+void DeleteVertexArray(GLuint &vao);
+
+// Forget everything, so the next bind of each kind reaches GL
+void Invalidate();
+
+// Called once a frame before drawing; also resets the stats
+void BeginFrame();
+GLStateStats GetStats();
+void DrawImGui();
+
+} // namespace GLState
+
+#endif
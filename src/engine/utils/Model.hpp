@@ -2,15 +2,21 @@
 #define MODEL_H
 
 #include "Buffer.hpp"
+#include "BufferArena.hpp"
+#include "CameraBuffer.hpp"
+#include "ChunkBatch.hpp"
 #include "../ecs/components/Camera.hpp"
 #include "../ResourceManager.hpp"
 #include "Font.h"
+#include "GLState.hpp"
 #include "SSBOBuffer.hpp"
 #include "Shader.hpp"
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/vector_float2.hpp>
+#include <glm/ext/vector_int2.hpp>
 #include <glm/ext/vector_float4.hpp>
 #include <glm/gtx/string_cast.hpp>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <glm/glm.hpp>
@@ -25,7 +31,7 @@ struct Model {
 
 	Model() {
 		glGenVertexArrays(1, &vao);
-		glBindVertexArray(vao);
+		GLState::BindVertexArray(vao);
 	}
 	Model(std::vector<std::string> binds) : Model() {
 		for (auto bind : binds) {
@@ -34,71 +40,72 @@ struct Model {
 		}
 	}
 	~Model() {
-		glDeleteVertexArrays(1, &vao);
+		GLState::DeleteVertexArray(vao);
 	}
 
 	template <typename T>
 	void Bind(std::string binding, Buffer *buffer) {
-		glBindVertexArray(vao);
-		glBindBuffer(GL_ARRAY_BUFFER, buffer->ID);
+		GLState::BindVertexArray(vao);
+		GLState::BindBuffer(GL_ARRAY_BUFFER, buffer->ID);
 		glVertexAttribPointer(bindingPoints[binding], sizeof(T) / sizeof(GL_FLOAT), GL_FLOAT, GL_FALSE, 0, (void *)0);
 
 		bindings[binding] = buffer;
 	}
 
+	// Point an attribute at a block of the GPU arena
+	template <typename T>
+	void Bind(std::string binding, const ArenaAllocation &allocation) {
+		GLState::BindVertexArray(vao);
+		GLState::BindBuffer(GL_ARRAY_BUFFER, GpuArena().ID);
+		glVertexAttribPointer(bindingPoints[binding], sizeof(T) / sizeof(GL_FLOAT), GL_FLOAT, GL_FALSE, 0,
+							  reinterpret_cast<void *>(allocation.offset));
+	}
+
 	void Render(GLenum mode = GL_TRIANGLE_STRIP) {
-		glBindVertexArray(vao);
+		GLState::BindVertexArray(vao);
 		glDrawArrays(mode, 0, SIZE);
-		glBindVertexArray(0);
 	}
 };
 
+// Vertices are streamed through the GPU arena each draw
 struct Quad : Model {
-	Buffer vert, tex;
-	Quad() : Model({"in_vert", "in_tex"}),
-			 vert({0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f}),
-			 tex({0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f}) {
-		Bind<glm::vec2>("in_vert", &vert);
-		Bind<glm::vec2>("in_tex", &tex);
+	Quad() : Model({"in_vert", "in_tex"}) {
 		SIZE = 4;
 	}
 	void Render(glm::vec2 position, glm::vec2 size, glm::vec4 color) {
+		static const float texCoords[] = {0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f};
 		std::vector<float> vertices = {position.x, position.y,			//
 									   position.x, position.y + size.y, //
 									   position.x + size.x, position.y, //
 									   position.x + size.x, position.y + size.y};
-		vert.Fill(vertices);
-		Bind<glm::vec2>("in_vert", &vert);
-		Shader shader = ResourceManager::GetShader("QuadShader");
+		ArenaAllocation vert = GpuArena().Stream(vertices);
+		ArenaAllocation tex = GpuArena().Stream(texCoords, 8);
+		if (!vert || !tex) return;
+		Bind<glm::vec2>("in_vert", vert);
+		Bind<glm::vec2>("in_tex", tex);
+		static Shader shader = ResourceManager::GetShader("QuadShader");
 		shader.use();
+		Cameras().Bind();
 
 		shader.setVec4("color", color);
-		glm::mat4 projection = Simplex::view.Camera->GetComponent<Camera>()->CalcualteScreenSpaceProjection();
-		shader.setMat4("projection", projection);
 		Model::Render();
 	}
 };
 struct Line : Model {
 };
 
+// Each glyph's quad is streamed through the GPU arena
 struct Text : Model {
 	glm::vec4 color = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
-	Buffer vert;
 
-	Text() : Model({"in_vert"}), vert() {
-		Bind<glm::vec4>("in_vert", &vert);
-	};
+	Text() : Model({"in_vert"}) {};
 
 	void Render(std::string text, glm::vec2 position, glm::vec2 size, glm::vec4 color, Font font = ResourceManager::GetFont("Arial")) {
-		Shader shader = ResourceManager::GetShader("TextShader");
+		static Shader shader = ResourceManager::GetShader("TextShader");
 		shader.use();
+		Cameras().Bind();
 
 		shader.setVec3("textColor", color);
-		glm::mat4 projection = Simplex::view.Camera->GetComponent<Camera>()->CalcualteScreenSpaceProjection();
-		shader.setMat4("projection", projection);
-
-		glActiveTexture(GL_TEXTURE0);
-		glBindVertexArray(vao);
 
 		// iterate through all characters
 		std::string::const_iterator c;
@@ -120,8 +127,10 @@ struct Text : Model {
 				{xpos + w, ypos + h, 1.0f, 0.0f}};
 
 			// render glyph texture over quad
-			glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-			vert.Fill(vertices);
+			GLState::BindTextureUnit(0, ch.TextureID);
+			ArenaAllocation vert = GpuArena().Stream(&vertices[0][0], 24);
+			if (!vert) break;
+			Bind<glm::vec4>("in_vert", vert);
 
 			// render quad
 			SIZE = 6;
@@ -129,7 +138,6 @@ struct Text : Model {
 
 			position.x += (ch.Advance >> 6) * size.x; // bitshift by 6 to get value in pixels (2^6 = 64)
 		}
-		glBindTexture(GL_TEXTURE_2D, 0);
 	}
 };
 
@@ -144,39 +152,47 @@ struct Triangle : Model {
 	}
 };
 
-struct ChunkModel : Model {
-	std::unordered_map<std::string, SSBO<unsigned int>> buffers;
-	ChunkModel() : Model() {};
+// A chunk's region of a ChunkBatch. Tiles are stored relative to origin, the
+// world tile position of the chunk's bottom left corner.
+struct ChunkModel {
+	ChunkBatch &batch;
+	uint32_t region;
+	glm::ivec2 origin = glm::ivec2(0);
 
-	void Fill(std::string texture, std::vector<unsigned int> buf) {
-		buffers[texture].Fill(buf);
-	}
-	void Set(std::string texture, int index, unsigned int value) {
-		buffers[texture].Set(index, value);
+	ChunkModel(ChunkBatch &batch) : batch(batch), region(batch.Allocate()) {};
+	~ChunkModel() {
+		batch.Free(region);
 	}
+	ChunkModel(const ChunkModel &) = delete;
+	ChunkModel &operator=(const ChunkModel &) = delete;
 
-	void Render() {
-		for (auto &pair : buffers) {
-			std::string textureName = pair.first;
-			SSBO<unsigned int> &ssbo = pair.second;
-
-			Shader shader = ResourceManager::GetShader("SpriteShader");
-			shader.use();
-
-			SIZE = ssbo.size / 2 * 6;
-			ssbo.Bind();
-
-			glm::mat4 projection = Simplex::view.Camera->GetComponent<Camera>()->CalculateWorldSpaceProjection();
-
-			shader.setVec4("color", glm::vec4(0.0, 0.0, 0.0, 0.0));
-			shader.setMat4("projection", projection);
-
-			glActiveTexture(GL_TEXTURE0);
-			ResourceManager::GetTexture(textureName).Bind();
-			Model::Render(GL_TRIANGLES);
+	void SetOrigin(glm::ivec2 position) {
+		origin = position;
+		batch.SetOrigin(region, origin);
+	}
+	// Replace every tile drawn
+	void Fill(const std::vector<unsigned int> &buf) {
+		batch.SetTiles(region, 0, buf);
+		batch.SetTileCount(region, buf.size());
+	}
+	void SetRange(size_t first, const std::vector<unsigned int> &values) {
+		batch.SetTiles(region, first, values);
+	}
+	void Resize(size_t size) {
+		batch.SetTileCount(region, size);
+	}
+	// One type per tile in tile index order, for the tilemap path
+	void SetTileTypes(const uint8_t *types) {
+		batch.SetTileTypes(region, types);
+	}
+	// The chunk's baked colours, drawn in its place when zoomed far out
+	void SetLodColours(const uint8_t *colours) {
+		batch.SetLodColours(region, colours);
+	}
 
-			glBindTexture(GL_TEXTURE0, 0);
-		}
+	// Drawn with the rest of the batch by ChunkBatch::Draw
+	void Queue() {
+		batch.Queue(region);
 	}
 };
 #endif
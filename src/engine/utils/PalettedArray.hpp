@@ -0,0 +1,169 @@
+#ifndef PALETTED_ARRAY_H
+#define PALETTED_ARRAY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fixed-size array of byte-sized values stored as indices into a local
+// palette, bit-packed at 0, 1, 2, 4 or 8 bits per entry. An array holding a
+// single value needs no index storage at all. The bit width grows when a
+// Set introduces a value that doesn't fit the palette; Compact shrinks it
+// again. Get and Set are constant time apart from that growth.
+template <typename T, size_t Count>
+class PalettedArray {
+	static_assert(sizeof(T) == 1, "PalettedArray holds byte-sized values");
+
+  public:
+	PalettedArray() : palette({T{}}) {}
+
+	T Get(size_t index) const {
+		if (bits == 0) return palette[0];
+		size_t bit = index * bits;
+		return palette[(words[bit >> 6] >> (bit & 63)) & Mask()];
+	}
+
+	void Set(size_t index, T value) {
+		size_t paletteIndex = FindOrAdd(value);
+		if (bits == 0) return;
+		size_t bit = index * bits;
+		uint64_t &word = words[bit >> 6];
+		word = (word & ~(Mask() << (bit & 63))) | (static_cast<uint64_t>(paletteIndex) << (bit & 63));
+	}
+
+	void Fill(T value) {
+		palette = {value};
+		bits = 0;
+		words.clear();
+		words.shrink_to_fit();
+	}
+
+	// Call fn(index, value) for every entry, in index order
+	template <typename Fn>
+	void ForEach(Fn fn) const {
+		if (bits == 0) {
+			for (size_t i = 0; i < Count; i++) {
+				fn(i, palette[0]);
+			}
+			return;
+		}
+
+		size_t perWord = 64 / bits;
+		uint64_t mask = Mask();
+		for (size_t w = 0, i = 0; w < words.size(); w++) {
+			uint64_t word = words[w];
+			for (size_t j = 0; j < perWord && i < Count; j++, i++) {
+				fn(i, palette[word & mask]);
+				word >>= bits;
+			}
+		}
+	}
+
+	// Drop unused palette entries and use the smallest bit width that fits
+	void Compact() {
+		std::vector<bool> used(palette.size(), bits == 0);
+		if (bits != 0) {
+			for (size_t i = 0; i < Count; i++) {
+				used[RawIndex(i)] = true;
+			}
+		}
+
+		std::vector<T> compacted;
+		for (size_t i = 0; i < palette.size(); i++) {
+			if (used[i] && std::find(compacted.begin(), compacted.end(), palette[i]) == compacted.end()) {
+				compacted.push_back(palette[i]);
+			}
+		}
+		if (compacted.size() == palette.size()) {
+			return;
+		}
+		Repack(compacted, BitsFor(compacted.size()));
+	}
+
+	const std::vector<T> &GetPalette() const { return palette; }
+	int GetBits() const { return bits; }
+	const std::vector<uint64_t> &GetWords() const { return words; }
+
+	// Replace the contents with previously saved state. Returns false, leaving
+	// the array untouched, if the state is inconsistent.
+	bool Load(std::vector<T> newPalette, int newBits, std::vector<uint64_t> newWords) {
+		if (newBits != 0 && newBits != 1 && newBits != 2 && newBits != 4 && newBits != 8) return false;
+		if (newPalette.empty() || newPalette.size() > (size_t(1) << newBits)) return false;
+		if (newWords.size() != WordsFor(newBits)) return false;
+		for (size_t i = 0; newBits != 0 && i < Count; i++) {
+			size_t bit = i * newBits;
+			if (((newWords[bit >> 6] >> (bit & 63)) & ((uint64_t(1) << newBits) - 1)) >= newPalette.size()) {
+				return false;
+			}
+		}
+
+		palette = std::move(newPalette);
+		bits = newBits;
+		words = std::move(newWords);
+		return true;
+	}
+
+	// Heap bytes owned by the array
+	size_t HeapBytes() const {
+		return palette.capacity() * sizeof(T) + words.capacity() * sizeof(uint64_t);
+	}
+
+	static size_t WordsFor(int bitWidth) {
+		return bitWidth == 0 ? 0 : (Count * bitWidth + 63) / 64;
+	}
+
+  private:
+	std::vector<T> palette;
+	std::vector<uint64_t> words;
+	int bits = 0;
+
+	uint64_t Mask() const { return (uint64_t(1) << bits) - 1; }
+
+	size_t RawIndex(size_t index) const {
+		size_t bit = index * bits;
+		return (words[bit >> 6] >> (bit & 63)) & Mask();
+	}
+
+	static int BitsFor(size_t paletteSize) {
+		if (paletteSize <= 1) return 0;
+		if (paletteSize <= 2) return 1;
+		if (paletteSize <= 4) return 2;
+		if (paletteSize <= 16) return 4;
+		return 8;
+	}
+
+	size_t FindOrAdd(T value) {
+		for (size_t i = 0; i < palette.size(); i++) {
+			if (palette[i] == value) return i;
+		}
+
+		std::vector<T> grown = palette;
+		grown.push_back(value);
+		if (grown.size() > (size_t(1) << bits)) {
+			Repack(grown, BitsFor(grown.size()));
+		} else {
+			palette = std::move(grown);
+		}
+		return palette.size() - 1;
+	}
+
+	// Re-encode every entry against a new palette and bit width. Every
+	// current value must be present in the new palette.
+	void Repack(const std::vector<T> &newPalette, int newBits) {
+		std::vector<uint64_t> newWords(WordsFor(newBits), 0);
+		if (newBits != 0) {
+			for (size_t i = 0; i < Count; i++) {
+				T value = Get(i);
+				uint64_t paletteIndex = std::find(newPalette.begin(), newPalette.end(), value) - newPalette.begin();
+				size_t bit = i * newBits;
+				newWords[bit >> 6] |= paletteIndex << (bit & 63);
+			}
+		}
+		palette = newPalette;
+		bits = newBits;
+		words = std::move(newWords);
+	}
+};
+
+#endif
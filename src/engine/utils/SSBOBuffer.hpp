@@ -2,28 +2,75 @@
 #define SSBO_H
 
 #include "Buffer.hpp"
+#include "GLState.hpp"
 #include "glad/glad.h"
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 
 template <typename T>
 struct SSBO {
 	unsigned int ID;
-	size_t size = 0;
+	size_t size = 0;	 // Elements in use
+	size_t capacity = 0; // Elements allocated
 	SSBO() {
 		glCreateBuffers(1, &ID);
 	}
+	~SSBO() {
+		GLState::DeleteBuffer(ID);
+	}
+	SSBO(const SSBO &) = delete;
+	SSBO &operator=(const SSBO &) = delete;
 
-	void Fill(std::vector<T> buf) {
+	// Upload buf, allocating room for at least reserve elements so later
+	// Sets can append without reallocating. Storage is immutable, so
+	// refilling replaces the buffer object.
+	void Fill(const std::vector<T> &buf, size_t reserve = 0) {
+		size_t newCapacity = std::max(buf.size(), reserve);
+		if (capacity > 0) {
+			GLState::DeleteBuffer(ID);
+			glCreateBuffers(1, &ID);
+		}
 		size = buf.size();
-		glNamedBufferStorage(ID, buf.size() * sizeof(T), buf.data(), GL_DYNAMIC_STORAGE_BIT);
+		capacity = newCapacity;
+		if (capacity == 0) return;
+
+		glNamedBufferStorage(ID, capacity * sizeof(T), nullptr, GL_DYNAMIC_STORAGE_BIT);
+		if (!buf.empty()) {
+			glNamedBufferSubData(ID, 0, buf.size() * sizeof(T), buf.data());
+		}
+	}
+
+	void Set(size_t index, T value) {
+		glNamedBufferSubData(ID, index * sizeof(T), sizeof(T), &value);
+	}
+
+	// Overwrite count elements starting at first; must fit the capacity
+	void SetRange(size_t first, const T *values, size_t count) {
+		glNamedBufferSubData(ID, first * sizeof(T), count * sizeof(T), values);
+	}
+
+	// Grow to hold at least newCapacity elements, keeping the contents
+	void Reserve(size_t newCapacity) {
+		if (newCapacity <= capacity) return;
+		unsigned int grown;
+		glCreateBuffers(1, &grown);
+		glNamedBufferStorage(grown, newCapacity * sizeof(T), nullptr, GL_DYNAMIC_STORAGE_BIT);
+		if (capacity > 0) {
+			glCopyNamedBufferSubData(ID, grown, 0, 0, capacity * sizeof(T));
+		}
+		GLState::DeleteBuffer(ID);
+		ID = grown;
+		capacity = newCapacity;
 	}
 
-	void Set(int index, T value) {
-		glNamedBufferSubData(ID, index, sizeof(T), &value);
+	// Change how many elements are in use without touching the contents
+	void Resize(size_t newSize) {
+		size = std::min(newSize, capacity);
 	}
 
-	void Bind() {
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ID);
+	void Bind(unsigned int binding = 0) {
+		GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, ID);
 	}
 };
 
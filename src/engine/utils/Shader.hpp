@@ -1,19 +1,26 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include "CameraBuffer.hpp"
+#include "GLState.hpp"
 #include <cstdlib>
 #include <fstream>
 #include <glad/glad.h>
 #include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_int2.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+// Uniform locations are looked up once per name and kept, shared between
+// copies of the shader since ResourceManager hands them out by value
 class Shader {
   public:
 	unsigned int ID;
@@ -94,32 +101,99 @@ class Shader {
 		}
 		glDeleteShader(vertexShader);
 		glDeleteShader(fragmentShader);
+		Linked();
 	};
 
-	void use() { glUseProgram(ID); };
+	void CompileCompute(const char *computeShaderPath) {
+		std::ifstream cStream;
+		cStream.open(computeShaderPath);
+		if (!cStream) {
+			std::cerr << "Failed to open compute shader!" << std::endl;
+		}
+		std::stringstream cBuffer;
+		cBuffer << cStream.rdbuf();
+		std::string computeShaderSource = cBuffer.str();
+		cStream.close();
+
+		const char *cShaderCode = computeShaderSource.c_str();
+		unsigned int computeShader = glCreateShader(GL_COMPUTE_SHADER);
+		glShaderSource(computeShader, 1, &cShaderCode, NULL);
+		glCompileShader(computeShader);
+
+		int success;
+		char infoLog[512];
+		glGetShaderiv(computeShader, GL_COMPILE_STATUS, &success);
+		if (!success) {
+			glGetShaderInfoLog(computeShader, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::COMPUTE::COMPILATION_FAILED\n"
+					  << infoLog << std::endl;
+		}
+
+		ID = glCreateProgram();
+		glAttachShader(ID, computeShader);
+		glLinkProgram(ID);
+
+		glGetProgramiv(ID, GL_LINK_STATUS, &success);
+		if (!success) {
+			glGetProgramInfoLog(ID, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
+					  << infoLog << std::endl;
+		}
+		glDeleteShader(computeShader);
+		Linked();
+	};
+
+	void use() { GLState::UseProgram(ID); };
+
+	int Location(const std::string &name) const {
+		if (!locations) return glGetUniformLocation(ID, name.c_str());
+		auto found = locations->find(name);
+		if (found != locations->end()) return found->second;
+		int location = glGetUniformLocation(ID, name.c_str());
+		locations->emplace(name, location);
+		return location;
+	}
 
 	void setBool(const std::string &name, bool value) const {
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+		glUniform1i(Location(name), (int)value);
 	}
 	void setInt(const std::string &name, int value) const {
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+		glUniform1i(Location(name), value);
 	}
 	void setFloat(const std::string &name, float value) const {
-		glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+		glUniform1f(Location(name), value);
+	}
+	void setIVec2(const std::string &name, glm::ivec2 value) const {
+		glUniform2i(Location(name), value.x, value.y);
 	}
 	void setVec2(const std::string &name, glm::vec2 value) const {
-		glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform2fv(Location(name), 1, &value[0]);
 	}
 	void setVec3(const std::string &name, glm::vec3 value) const {
-		glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform3fv(Location(name), 1, &value[0]);
+	}
+	void setUInt(const std::string &name, unsigned int value) const {
+		glUniform1ui(Location(name), value);
 	}
 	void setVec4(const std::string &name, glm::vec4 value) const {
-		glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform4fv(Location(name), 1, &value[0]);
 	}
 	void setMat4(const std::string &name, glm::mat4 &value) const {
-		glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE,
+		glUniformMatrix4fv(Location(name), 1, GL_FALSE,
 						   &value[0][0]);
 	}
+
+  private:
+	std::shared_ptr<std::unordered_map<std::string, int>> locations;
+
+	// Fresh location cache, and the camera block, if used, on its binding
+	void Linked() {
+		locations = std::make_shared<std::unordered_map<std::string, int>>();
+		unsigned int cameraBlock = glGetUniformBlockIndex(ID, "CameraBlock");
+		if (cameraBlock != GL_INVALID_INDEX) {
+			glUniformBlockBinding(ID, cameraBlock, CameraBuffer::Binding);
+		}
+	}
 };
 
 #endif
@@ -1,4 +1,5 @@
 #include "Texture.hpp"
+#include "GLState.hpp"
 #include <glm/common.hpp>
 
 Texture2D::Texture2D()
@@ -29,6 +30,8 @@ void Texture2D::Generate(unsigned int width, unsigned int height,
     glGenerateMipmap(GL_TEXTURE_2D);
 	// unbind texture
 	glBindTexture(GL_TEXTURE_2D, 0);
+	// Bound behind the state cache's back
+	GLState::Invalidate();
 }
 
 glm::vec4 Texture2D::GetPixel(glm::vec2 texCoord) const {
@@ -43,4 +46,4 @@ glm::vec4 Texture2D::GetPixel(glm::vec2 texCoord) const {
 	return glm::vec4(textureData[index] / 255.0f, textureData[index + 1] / 255.0f, textureData[index + 2] / 255.0f, textureData[index + 3] / 255.0f);
 }
 
-void Texture2D::Bind() const { glBindTexture(GL_TEXTURE_2D, this->ID); }
+void Texture2D::Bind(unsigned int unit) const { GLState::BindTextureUnit(unit, this->ID); }
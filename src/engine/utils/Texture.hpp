@@ -32,8 +32,8 @@ class Texture2D {
 	// Gets the rgba values of a given texture coordiante
 	glm::vec4 GetPixel(glm::vec2 texCoord) const;
 
-	// binds the texture as the current active GL_TEXTURE_2D texture object
-	void Bind() const;
+	// binds the texture to a texture unit, through the state cache
+	void Bind(unsigned int unit = 0) const;
 };
 
 #endif
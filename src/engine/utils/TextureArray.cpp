@@ -0,0 +1,35 @@
+#include "TextureArray.hpp"
+#include "GLState.hpp"
+#include <algorithm>
+#include <cmath>
+
+void TextureArray::Generate(unsigned int width, unsigned int height, const std::vector<const Texture2D *> &layers) {
+	Width = width;
+	Height = height;
+	Layers = static_cast<unsigned int>(layers.size());
+	if (Layers == 0) return;
+
+	int levels = 1 + static_cast<int>(std::floor(std::log2(std::max(width, height))));
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &ID);
+	glTextureStorage3D(ID, levels, GL_RGBA8, width, height, Layers);
+
+	unsigned char transparent[4] = {0, 0, 0, 0};
+	glClearTexImage(ID, 0, GL_RGBA, GL_UNSIGNED_BYTE, transparent);
+	for (unsigned int layer = 0; layer < Layers; layer++) {
+		const Texture2D *texture = layers[layer];
+		if (!texture || texture->Width != width || texture->Height != height) continue;
+		if (texture->textureData.size() < size_t(width) * height * 4) continue;
+
+		glTextureSubImage3D(ID, 0, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+							texture->textureData.data());
+	}
+
+	// Matches Texture2D's defaults so tiles look the same as before
+	glTextureParameteri(ID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTextureParameteri(ID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTextureParameteri(ID, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+	glTextureParameteri(ID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glGenerateTextureMipmap(ID);
+}
+
+void TextureArray::Bind(unsigned int unit) const { GLState::BindTextureUnit(unit, ID); }
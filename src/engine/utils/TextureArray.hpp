@@ -0,0 +1,23 @@
+#ifndef TEXTURE_ARRAY_H
+#define TEXTURE_ARRAY_H
+
+#include "Texture.hpp"
+#include <glad/glad.h>
+#include <vector>
+
+// Same-sized RGBA images as layers of one GL_TEXTURE_2D_ARRAY, so a shader
+// can pick between them per vertex without rebinding
+class TextureArray {
+  public:
+	unsigned int ID = 0;
+	unsigned int Width = 0, Height = 0;
+	unsigned int Layers = 0;
+
+	// Builds the array from the pixels the textures kept when generated.
+	// Null entries, and textures of another size, are left transparent.
+	void Generate(unsigned int width, unsigned int height, const std::vector<const Texture2D *> &layers);
+
+	void Bind(unsigned int unit = 0) const;
+};
+
+#endif
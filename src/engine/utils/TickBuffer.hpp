@@ -0,0 +1,42 @@
+#ifndef TICK_BUFFER_H
+#define TICK_BUFFER_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+// The last two states published by a fixed-rate producer, for a consumer
+// running at its own rate to interpolate between. Publishing only swaps
+// pointers under the lock, and a reader keeps the states it took alive for
+// as long as it holds them, so neither side ever waits on the other's work.
+template <typename State>
+class TickBuffer {
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Frame {
+		std::shared_ptr<const State> previous; // Null until two states are published
+		std::shared_ptr<const State> current;  // Null until one state is published
+		Clock::time_point published;		   // When current was published
+	};
+
+	void Publish(State state) {
+		auto next = std::make_shared<const State>(std::move(state));
+		std::lock_guard<std::mutex> lock(mutex);
+		frame.previous = std::move(frame.current);
+		frame.current = std::move(next);
+		frame.published = Clock::now();
+	}
+
+	Frame Read() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return frame;
+	}
+
+  private:
+	Frame frame;
+	mutable std::mutex mutex;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#version 430 core
+
+layout(local_size_x = 64) in;
+
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint first;
+    uint baseInstance;
+};
+
+// World tile position of each region's bottom left corner
+layout(std430, binding = 1) readonly buffer chunkOriginBuffer
+{
+    ivec2 chunkOrigins[];
+};
+
+// Per region: first tile word in the arena, and tiles drawn
+layout(std430, binding = 3) readonly buffer chunkDrawBuffer
+{
+    uvec2 chunkDraws[];
+};
+
+layout(std430, binding = 4) writeonly buffer commandBuffer
+{
+    DrawCommand commands[];
+};
+
+layout(std430, binding = 5) buffer drawCountBuffer
+{
+    uint drawCount;
+};
+
+uniform uint regionCount;
+uniform int chunkSize;
+// One quad per chunk, for the tilemap and LOD passes
+uniform bool quads;
+// Left, bottom, right, top in world tiles
+uniform vec4 viewRect;
+
+void main()
+{
+    uint region = gl_GlobalInvocationID.x;
+    if (region >= regionCount) {
+        return;
+    }
+
+    // Free regions and chunks without tiles draw nothing
+    uvec2 draw = chunkDraws[region];
+    if (draw.y == 0u) {
+        return;
+    }
+
+    vec2 low = vec2(chunkOrigins[region]);
+    vec2 high = low + vec2(chunkSize);
+    if (high.x < viewRect.x || low.x > viewRect.z || high.y < viewRect.y || low.y > viewRect.w) {
+        return;
+    }
+
+    uint slot = atomicAdd(drawCount, 1u);
+    if (quads) {
+        commands[slot] = DrawCommand(6u, 1u, 0u, region);
+    } else {
+        commands[slot] = DrawCommand(draw.y * 6u, 1u, draw.x * 6u, region);
+    }
+}
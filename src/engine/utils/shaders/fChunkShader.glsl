@@ -0,0 +1,11 @@
+#version 430 core
+
+out vec4 FragColor;
+in vec2 ourTexCoord;
+flat in uint layer;
+
+uniform sampler2DArray tileTextures;
+
+void main() {
+    FragColor = texture(tileTextures, vec3(ourTexCoord, float(layer)));
+}
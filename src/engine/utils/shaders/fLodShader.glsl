@@ -0,0 +1,19 @@
+#version 430 core
+
+out vec4 FragColor;
+in vec2 tilePosition;
+flat in int region;
+
+// Baked colours of every region, one slice each
+uniform sampler2DArray lodColours;
+uniform int chunkSize;
+// How far the LOD has faded in over the tiles
+uniform float lodAlpha;
+
+void main() {
+    vec4 colour = texture(lodColours, vec3(tilePosition / float(chunkSize), float(region)));
+    if (colour.a == 0.0) {
+        discard;
+    }
+    FragColor = vec4(colour.rgb, colour.a * lodAlpha);
+}
@@ -0,0 +1,23 @@
+#version 430 core
+
+out vec4 FragColor;
+in vec2 tilePosition;
+flat in int region;
+
+// Tile types of every region, one slice each
+uniform usampler2DArray tileTypes;
+uniform sampler2DArray tileTextures;
+uniform int chunkSize;
+
+void main() {
+    ivec2 tile = clamp(ivec2(floor(tilePosition)), ivec2(0), ivec2(chunkSize - 1));
+    uint type = texelFetch(tileTypes, ivec3(tile, region), 0).r;
+    if (type == 0u) {
+        discard;
+    }
+
+    // Gradients of the unwrapped position keep mip selection smooth across
+    // tile edges, where fract jumps
+    vec2 uv = fract(tilePosition);
+    FragColor = textureGrad(tileTextures, vec3(uv, float(type)), dFdx(tilePosition), dFdy(tilePosition));
+}
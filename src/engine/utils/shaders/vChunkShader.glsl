@@ -0,0 +1,64 @@
+#version 430 core
+
+// The whole GPU arena; each draw starts at its chunk's first tile
+layout(std430, binding = 0) readonly buffer vertexPullBuffer
+{
+    uint packedTiles[]; // One packed tile per entry
+};
+
+// World tile position of each region's bottom left corner
+layout(std430, binding = 1) readonly buffer chunkOriginBuffer
+{
+    ivec2 chunkOrigins[];
+};
+
+// The draw's base instance, which is its chunk's region
+layout(location = 0) in uint region;
+
+out vec2 ourTexCoord;
+flat out uint layer;
+
+// Offsets for our vertices drawing this face
+const vec2 facePositions[4] = vec2[4](
+        vec2(0.0, 0.0),
+        vec2(0.0, 1.0),
+        vec2(1.0, 1.0),
+        vec2(1.0, 0.0)
+    );
+
+// Winding order to access the face positions
+int indices[6] = {
+        0,
+        1,
+        2,
+        3,
+        0,
+        2
+    };
+
+// Shared by every draw; see CameraBuffer
+layout(std140) uniform CameraBlock
+{
+    mat4 worldProjection;
+    mat4 screenProjection;
+};
+
+void main()
+{
+    int index = gl_VertexID / 6;
+    ivec2 chunkOrigin = chunkOrigins[region];
+    int currVertexID = gl_VertexID % 6;
+
+    // Bits 0-4 local x, 5-9 local y, 10-17 tile type, 18-25 variant
+    uint tile = packedTiles[index];
+    int x = int(tile & 0x1Fu);
+    int y = int((tile >> 5) & 0x1Fu);
+
+    vec2 face = facePositions[indices[currVertexID]];
+    vec2 position = vec2(chunkOrigin + ivec2(x, y)) + face;
+
+    gl_Position = worldProjection * vec4(position, 0.0, 1.0);
+    ourTexCoord = face;
+    // The tile type is the texture array layer
+    layer = (tile >> 10) & 0xFFu;
+}
@@ -2,9 +2,14 @@
 layout(location = 0) in vec2 vertex;
 layout(location = 1) in vec2 texCoords;
 
-uniform mat4 projection;
+// Shared by every draw; see CameraBuffer
+layout(std140) uniform CameraBlock
+{
+    mat4 worldProjection;
+    mat4 screenProjection;
+};
 
 void main()
 {
-    gl_Position = projection * vec4(vertex, 0.0, 1.0);
+    gl_Position = screenProjection * vec4(vertex, 0.0, 1.0);
 }
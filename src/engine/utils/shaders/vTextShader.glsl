@@ -2,10 +2,15 @@
 layout(location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
 out vec2 TexCoords;
 
-uniform mat4 projection;
+// Shared by every draw; see CameraBuffer
+layout(std140) uniform CameraBlock
+{
+    mat4 worldProjection;
+    mat4 screenProjection;
+};
 
 void main()
 {
-    gl_Position = projection * vec4(vertex.xy, 11.0, 1.0);
+    gl_Position = screenProjection * vec4(vertex.xy, 11.0, 1.0);
     TexCoords = vertex.zw;
 }
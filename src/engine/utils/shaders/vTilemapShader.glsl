@@ -0,0 +1,50 @@
+#version 430 core
+
+// World tile position of each region's bottom left corner
+layout(std430, binding = 1) readonly buffer chunkOriginBuffer
+{
+    ivec2 chunkOrigins[];
+};
+
+// The draw's base instance, which is its chunk's region
+layout(location = 0) in uint chunkRegion;
+
+out vec2 tilePosition;
+flat out int region;
+
+// Offsets for our vertices drawing this face
+const vec2 facePositions[4] = vec2[4](
+        vec2(0.0, 0.0),
+        vec2(0.0, 1.0),
+        vec2(1.0, 1.0),
+        vec2(1.0, 0.0)
+    );
+
+// Winding order to access the face positions
+int indices[6] = {
+        0,
+        1,
+        2,
+        3,
+        0,
+        2
+    };
+
+// Shared by every draw; see CameraBuffer
+layout(std140) uniform CameraBlock
+{
+    mat4 worldProjection;
+    mat4 screenProjection;
+};
+uniform int chunkSize;
+
+void main()
+{
+    region = int(chunkRegion);
+
+    // The quad covers the whole chunk, in tiles from its corner
+    tilePosition = facePositions[indices[gl_VertexID]] * float(chunkSize);
+    vec2 position = vec2(chunkOrigins[region]) + tilePosition;
+
+    gl_Position = worldProjection * vec4(position, 0.0, 1.0);
+}
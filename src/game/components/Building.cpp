@@ -0,0 +1,65 @@
+#include "Building.hpp"
+#include "../../engine/utils/ChunkMap.hpp"
+
+namespace {
+
+// Building entity on each tile. Simulation thread only.
+ChunkMap<EntityId> &TileIndex() {
+	static ChunkMap<EntityId> index;
+	return index;
+}
+
+// Posted edits run before the tick's systems, so nothing is iterating yet
+void RemoveAt(Registry &registry, glm::ivec2 tile) {
+	auto it = TileIndex().find(tile);
+	if (it == TileIndex().end()) return;
+	registry.Destroy(it->second);
+	TileIndex().erase(it);
+}
+
+// Keep the sprite of each building added or changed since the cursor.
+// Buildings only change through posted edits, which run before the systems,
+// so every change is stamped with the current tick or an earlier one.
+void UpdateSprites(Registry &registry, uint64_t &cursor) {
+	ComponentPool<RenderSprite> &sprites = registry.Pool<RenderSprite>();
+	registry.Pool<Building>().ForEachChangedSince(cursor, [&](EntityId entity, Building &building) {
+		RenderSprite &sprite = sprites.Emplace(entity);
+		sprite.position = glm::vec3(building.tile.x, building.tile.y, 0.0f);
+		sprite.texture = building.texture;
+	});
+	cursor = registry.GetTick() + 1;
+}
+
+} // namespace
+
+namespace Buildings {
+
+void AddSystems(Simulation &simulation) {
+	uint64_t cursor = 0;
+	simulation.systems.Add("Building Sprites", SystemAccess().Read<Building>().Write<RenderSprite>(),
+						   [cursor](Registry &registry) mutable { UpdateSprites(registry, cursor); });
+}
+
+void Place(Simulation &simulation, Building building) {
+	simulation.Post([building](Registry &registry) {
+		RemoveAt(registry, building.tile);
+		EntityId entity = registry.Create();
+		registry.Add<Building>(entity, building);
+		TileIndex()[building.tile] = entity;
+	});
+}
+
+void Remove(Simulation &simulation, glm::ivec2 tile) {
+	simulation.Post([tile](Registry &registry) { RemoveAt(registry, tile); });
+}
+
+void Clear(Simulation &simulation) {
+	simulation.Post([](Registry &registry) {
+		for (auto &[tile, entity] : TileIndex()) {
+			registry.Destroy(entity);
+		}
+		TileIndex().clear();
+	});
+}
+
+} // namespace Buildings
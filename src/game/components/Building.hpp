@@ -0,0 +1,32 @@
+#ifndef BUILDING_H
+#define BUILDING_H
+
+#include "../../engine/Simulation.hpp"
+#include <glm/ext/vector_int2.hpp>
+
+// A building standing on one map tile. Buildings live in the simulation's
+// registry and update on its tick, so they keep running at a fixed rate
+// whether or not their chunk is loaded or drawn. Chunks only flag the tiles
+// buildings stand on.
+struct Building {
+	glm::ivec2 tile = glm::ivec2(0); // World tile
+	unsigned int texture = 0;		 // GL texture it is drawn with
+};
+
+// Places and removes buildings by tile. Called from the main thread; each
+// edit is posted to the simulation and applied before its next tick, where
+// the building systems pick it up.
+namespace Buildings {
+
+// Register the building systems. Before the simulation starts.
+void AddSystems(Simulation &simulation);
+
+// Replaces any building already on the tile
+void Place(Simulation &simulation, Building building);
+void Remove(Simulation &simulation, glm::ivec2 tile);
+// Every building, e.g. when the map is regenerated
+void Clear(Simulation &simulation);
+
+} // namespace Buildings
+
+#endif
@@ -1,18 +1,42 @@
 #include "Chunk.hpp"
+#include "Building.hpp"
 #include "ChunkRenderer.hpp"
-#include <future>
 #include "Map.hpp"
 #include "MapGenerator.hpp"
+#include "../../engine/Simplex.hpp"
+#include "../../engine/async/Scheduler.hpp"
 
-void Chunk::Generate(GeneratorSettings settings) {
-	std::future generatedTiles = std::async(MapGenerator::Generate, transform->position.x, transform->position.y, settings);
-    tiles = generatedTiles.get();
+Task<void> Chunk::Generate(GeneratorSettings settings) {
+	Generating = true;
+	glm::ivec2 position = transform->position;
+
+	co_await Async::Pool().Schedule();
+	ChunkSummary generatedSummary;
+	ChunkTiles generatedTiles = MapGenerator::Generate(position.x, position.y, settings, &generatedSummary);
+
+	co_await Async::MainThread().NextFrame();
+	tiles = generatedTiles;
+	summary = generatedSummary;
 	Generated = true;
+	Generating = false;
 	//renderer->AddChunkToSSBO(*this);
 }
 
-void Chunk::Update() {
-	for (auto tile : tiles) {
-		tile->UpdateComponents();
+size_t Chunk::ResidentBytes() const {
+	// Palette compressed tiles plus the renderer's GPU buffers
+	return sizeof(Chunk) + tiles->HeapBytes() + renderer->ResidentBytes();
+}
+
+bool Chunk::HasBuilding(int localX, int localY) const {
+	return tiles->HasFlag(ChunkTiles::Index(localX, localY), TILE_FLAG_BUILDING);
+}
+
+void Chunk::SetBuilding(int localX, int localY, unsigned int texture) {
+	glm::ivec2 tile = transform->position * CHUNK_SIZE + glm::ivec2(localX, localY);
+	if (texture != 0) {
+		Buildings::Place(Simplex::simulation, {tile, texture});
+	} else if (HasBuilding(localX, localY)) {
+		Buildings::Remove(Simplex::simulation, tile);
 	}
+	tiles.Write().SetFlag(ChunkTiles::Index(localX, localY), TILE_FLAG_BUILDING, texture != 0);
 }
@@ -1,10 +1,15 @@
 #ifndef CHUNK_H
 #define CHUNK_H
 
+#include "../../engine/async/Task.hpp"
+#include "../../engine/utils/CowPtr.hpp"
+#include "../../engine/ecs/Entity.hpp"
 #include "../../engine/ecs/IComponent.hpp"
-#include "../entities/TileEntity.hpp"
+#include "ChunkSummary.hpp"
+#include "ChunkTiles.hpp"
 #include "ChunkTransform.hpp"
 #include "../utils/GeneratorSettings.hpp"
+#include <bitset>
 
 struct ChunkRenderer;
 
@@ -12,15 +17,42 @@ struct Chunk : IComponent {
 	ChunkTransform *transform;
 	ChunkRenderer *renderer;
 
-	std::vector<TileEntity *> tiles;
+	// Copy-on-write so snapshots can be read off the main thread while the
+	// chunk keeps being edited
+	CowPtr<ChunkTiles> tiles;
+	ChunkSummary summary;
+	// Tiles whose type changed since the renderer last synced
+	std::bitset<CHUNK_AREA> changedTiles;
 	bool Generated = false;
+	bool Generating = false;
 
-	Chunk(ChunkRenderer *renderer, ChunkTransform *transform) : renderer(renderer),
-																transform(transform) {};
-
-	void Generate(GeneratorSettings settings);
+	// Loaded chunks around this one, maintained by World. Indexed by
+	// (dy + 1) * 3 + (dx + 1); the centre slot is the chunk itself.
+	Chunk *neighbours[9] = {};
 
-	void Update() override;
+	Chunk(ChunkRenderer *renderer, ChunkTransform *transform) : renderer(renderer),
+																transform(transform) {
+		neighbours[4] = this;
+		Sleep();
+	};
+	Chunk(const Chunk &) = delete;
+	Chunk &operator=(const Chunk &) = delete;
+
+	// Approximate CPU + GPU bytes held while this chunk is resident
+	size_t ResidentBytes() const;
+
+	// Loaded chunk at an offset of up to one chunk in each axis, or nullptr
+	Chunk *Neighbour(int dx, int dy) const { return neighbours[(dy + 1) * 3 + (dx + 1)]; }
+
+	bool HasBuilding(int localX, int localY) const;
+	// Place a building of the texture on the tile, replacing any there, or
+	// remove it with texture 0. The building itself is simulated and
+	// outlives the chunk being evicted; see Buildings.
+	void SetBuilding(int localX, int localY, unsigned int texture);
+
+	// Generates the tiles on the thread pool and installs them on the main
+	// thread. The chunk must not be deleted while Generating is set.
+	Task<void> Generate(GeneratorSettings settings);
 };
 
 #endif
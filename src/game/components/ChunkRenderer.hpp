@@ -1,57 +1,282 @@
 #ifndef CHUNK_RENDERER_H
 #define CHUNK_RENDERER_H
 
+#include "../../engine/ResourceManager.hpp"
 #include "../../engine/ecs/IComponent.hpp"
+#include "../../engine/utils/ChunkBatch.hpp"
 #include "../../engine/utils/Model.hpp"
 #include "Chunk.hpp"
-#include "../entities/TileEntity.hpp"
-#include "TileTexture.hpp"
-#include "TileTransform.hpp"
+#include "ChunkTiles.hpp"
+#include <algorithm>
+#include <array>
 #include <cstddef>
-#include <unordered_map>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <glm/ext/vector_float3.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <glm/ext/vector_int2.hpp>
 #include <vector>
 
+// Draws a chunk's tiles from its region of the shared tile batch. Each drawn
+// tile owns a slot holding one packed word, positioned relative to the chunk
+// origin so world coordinates aren't limited by the encoding, with its type
+// doubling as the layer of the tile texture array. Emptied tiles are removed
+// by swapping in the last slot, and only the touched slots are uploaded.
+// The tile types are kept in the batch too, for drawing the chunk as a
+// single tilemap quad, along with a small texture of its average colours
+// drawn in its place when zoomed far out.
 struct ChunkRenderer : IComponent {
+	static constexpr size_t WordsPerTile = 1;
+	// LOD texels per side; each averages a square of tiles
+	static constexpr int LodSize = 16;
+	static constexpr int LodTexelTiles = CHUNK_SIZE / LodSize;
+	static_assert(CHUNK_SIZE % LodSize == 0);
+	using LodTexels = std::array<uint8_t, LodSize * LodSize * 4>;
+
 	ChunkModel *model;
 
-	ChunkRenderer(ChunkModel *model) : model(model) {};
+	// Drawn by the map for chunks in view rather than updated
+	ChunkRenderer(ChunkModel *model) : model(model) { Sleep(); };
+	~ChunkRenderer() {
+		delete model;
+	}
+
+	// Shared by every chunk, with one region per chunk. Created on first use,
+	// after the tile textures have loaded, and kept for the program's life.
+	static ChunkBatch &Batch() {
+		static ChunkBatch *batch = [] {
+			std::vector<std::string> layers;
+			for (int type = 0; type < TILE_TYPE_COUNT; type++) {
+				layers.push_back(TileTypeName(static_cast<TILE_TYPE>(type)));
+			}
+			ResourceManager::LoadTextureArray("TILE_TEXTURES", layers);
+			return new ChunkBatch(CHUNK_SIZE, LodSize, {"ChunkShader", "TilemapShader", "LodShader", "ChunkCullShader"},
+								  "TILE_TEXTURES");
+		}();
+		return *batch;
+	}
+
+	// Submit every chunk queued this frame in one draw
+	static void DrawQueued() {
+		Batch().Draw();
+	}
+
+	// Draw every chunk in view, culled on the GPU, without queueing any
+	static void DrawVisible() {
+		Batch().DrawVisible();
+	}
 
-	void UpdateTile(int index, TileEntity *tile) {
-		std::vector<unsigned int> vertices = TileToVertices(tile);
-		for (size_t i = 0; i < vertices.size(); i++) {
-			model->Set(tile->GetComponent<TileTexture>()->texture, index + i, vertices[0 + i]);
+	void AddChunkToSSBO(Chunk &chunk) {
+		model->SetOrigin(chunk.transform->position * CHUNK_SIZE);
+		tiles.clear();
+		dirtySlots.clear();
+
+		chunk.tiles->types.ForEach([&](size_t index, TILE_TYPE type) {
+			drawnTypes[index] = type;
+			if (type == TILE_EMPTY) return;
+
+			slots[index] = static_cast<uint16_t>(tiles.size());
+			tiles.push_back(static_cast<uint16_t>(index));
+		});
+		model->Fill(SlotVertices(0, tiles.size()));
+		UploadTileTypes();
+		model->SetLodColours(BakeLod().data());
+		chunk.changedTiles.reset();
+		stagedRuns.clear();
+		syncStaged = false;
+	}
+
+	// Bring the renderer in line with the tiles marked in chunk.changedTiles
+	// and stage what the region needs, without touching GL or the batch, so
+	// edited chunks can be prepared in parallel. Any number of edits collapse
+	// into one staged run per run of touched slots. Returns false if there
+	// was nothing to do.
+	bool PrepareSync(Chunk &chunk) {
+		if (chunk.changedTiles.none()) return false;
+
+		for (size_t index = 0; index < CHUNK_AREA; index++) {
+			if (!chunk.changedTiles.test(index)) continue;
+
+			TILE_TYPE type = chunk.tiles->GetType(static_cast<int>(index));
+			TILE_TYPE drawn = drawnTypes[index];
+			if (type == drawn) continue;
+			if (drawn != TILE_EMPTY && type != TILE_EMPTY) {
+				// Same slot, new layer
+				drawnTypes[index] = type;
+				dirtySlots.push_back(slots[index]);
+				continue;
+			}
+			RemoveTile(index);
+			AddTile(index, type);
 		}
+		chunk.changedTiles.reset();
+		StageDirtyRuns();
+		stagedLod = BakeLod();
+		syncStaged = true;
+		return true;
 	}
 
-	void AddChunkToSSBO(Chunk chunk) {
-		std::unordered_map<std::string, std::vector<TileEntity *>> textureSeperatedTiles;
-		for (auto tile : chunk.tiles) {
-			textureSeperatedTiles[tile->GetComponent<TileTexture>()->texture].push_back(tile);
+	// Upload what PrepareSync staged. Main thread only.
+	void UploadSync() {
+		if (!syncStaged) return;
+		for (const auto &[first, words] : stagedRuns) {
+			model->SetRange(first, words);
 		}
-		for (auto pair : textureSeperatedTiles) {
-			std::string textureName = pair.first;
-			std::vector<TileEntity *> tiles = pair.second;
-
-			std::vector<unsigned int> chunkVertices;
-			for (auto tile : tiles) {
-				for (auto vertex : TileToVertices(tile)) {
-					chunkVertices.push_back(vertex);
+		stagedRuns.clear();
+		model->Resize(tiles.size() * WordsPerTile);
+		// The whole slice is a single kilobyte, less than tracking rows
+		UploadTileTypes();
+		model->SetLodColours(stagedLod.data());
+		syncStaged = false;
+	}
+
+	// Bookkeeping plus the chunk's region of the batch, which is reserved
+	// whole however many tiles are drawn
+	size_t ResidentBytes() const {
+		return sizeof(slots) + sizeof(drawnTypes) + tiles.capacity() * sizeof(uint16_t) +
+			   dirtySlots.capacity() * sizeof(uint16_t) + model->batch.GetRegionBytes();
+	}
+
+	// Bits 0-4 local x, 5-9 local y, 10-17 tile type, 18-25 variant
+	static unsigned int PackTile(int index, TILE_TYPE type, uint8_t variant = 0) {
+		glm::ivec2 local = ChunkTiles::LocalPosition(index);
+		return static_cast<unsigned int>(local.x) | (static_cast<unsigned int>(local.y) << 5) |
+			   (static_cast<unsigned int>(type) << 10) | (static_cast<unsigned int>(variant) << 18);
+	}
+
+	// Add the chunk to this frame's batch; see DrawQueued. Not needed with
+	// DrawVisible, which finds chunks in view itself.
+	void Render() {
+		model->Queue();
+	}
+
+  private:
+	std::vector<uint16_t> tiles;	  // Tile index drawn by each slot
+	std::vector<uint16_t> dirtySlots; // Slots rewritten since the last flush
+	// Per tile: the type it is drawn as and its slot
+	std::array<uint16_t, CHUNK_AREA> slots = {};
+	std::array<TILE_TYPE, CHUNK_AREA> drawnTypes = {};
+	// Staged by PrepareSync for UploadSync: runs of slot words by first word
+	std::vector<std::pair<size_t, std::vector<unsigned int>>> stagedRuns;
+	LodTexels stagedLod = {};
+	bool syncStaged = false;
+
+	void RemoveTile(size_t index) {
+		TILE_TYPE type = drawnTypes[index];
+		drawnTypes[index] = TILE_EMPTY;
+		if (type == TILE_EMPTY) return;
+
+		uint16_t slot = slots[index];
+		uint16_t last = tiles.back();
+		tiles.pop_back();
+		if (slot < tiles.size()) {
+			tiles[slot] = last;
+			slots[last] = slot;
+			dirtySlots.push_back(slot);
+		}
+	}
+
+	void AddTile(size_t index, TILE_TYPE type) {
+		drawnTypes[index] = type;
+		if (type == TILE_EMPTY) return;
+
+		slots[index] = static_cast<uint16_t>(tiles.size());
+		tiles.push_back(static_cast<uint16_t>(index));
+		dirtySlots.push_back(slots[index]);
+	}
+
+	// Average colour of each tile type's texture, weighted by alpha so
+	// transparent texels don't darken it. Empty tiles stay transparent.
+	static const std::array<glm::vec4, TILE_TYPE_COUNT> &TileColours() {
+		static const std::array<glm::vec4, TILE_TYPE_COUNT> colours = [] {
+			std::array<glm::vec4, TILE_TYPE_COUNT> averages = {};
+			for (int type = 1; type < TILE_TYPE_COUNT; type++) {
+				auto texture = ResourceManager::Textures.find(TileTypeName(static_cast<TILE_TYPE>(type)));
+				if (texture == ResourceManager::Textures.end()) continue;
+
+				const std::vector<unsigned char> &data = texture->second.textureData;
+				glm::vec3 colour(0.0f);
+				float alpha = 0.0f;
+				for (size_t i = 0; i + 3 < data.size(); i += 4) {
+					float a = data[i + 3] / 255.0f;
+					colour += glm::vec3(data[i], data[i + 1], data[i + 2]) * (a / 255.0f);
+					alpha += a;
+				}
+				size_t texels = data.size() / 4;
+				if (alpha > 0.0f) {
+					averages[type] = glm::vec4(colour / alpha, alpha / texels);
 				}
 			}
-			model->Fill(textureName, chunkVertices);
+			return averages;
+		}();
+		return colours;
+	}
+
+	// Each texel averages its square of tiles, empty ones included, so
+	// partly filled edges fade out rather than stop hard
+	LodTexels BakeLod() const {
+		const std::array<glm::vec4, TILE_TYPE_COUNT> &colours = TileColours();
+		LodTexels texels;
+		for (int y = 0; y < LodSize; y++) {
+			for (int x = 0; x < LodSize; x++) {
+				glm::vec3 colour(0.0f);
+				float alpha = 0.0f;
+				for (int ty = 0; ty < LodTexelTiles; ty++) {
+					for (int tx = 0; tx < LodTexelTiles; tx++) {
+						int index = ChunkTiles::Index(x * LodTexelTiles + tx, y * LodTexelTiles + ty);
+						const glm::vec4 &tile = colours[drawnTypes[index]];
+						colour += glm::vec3(tile) * tile.a;
+						alpha += tile.a;
+					}
+				}
+				if (alpha > 0.0f) colour /= alpha;
+				alpha /= LodTexelTiles * LodTexelTiles;
+
+				uint8_t *texel = &texels[(y * LodSize + x) * 4];
+				texel[0] = static_cast<uint8_t>(colour.x * 255.0f + 0.5f);
+				texel[1] = static_cast<uint8_t>(colour.y * 255.0f + 0.5f);
+				texel[2] = static_cast<uint8_t>(colour.z * 255.0f + 0.5f);
+				texel[3] = static_cast<uint8_t>(alpha * 255.0f + 0.5f);
+			}
 		}
+		return texels;
 	}
 
-	std::vector<unsigned int> TileToVertices(TileEntity *tile) {
-		TileTransform *transform = tile->GetComponent<TileTransform>();
+	// drawnTypes is already in the slice's row order
+	void UploadTileTypes() {
+		static_assert(sizeof(TILE_TYPE) == sizeof(uint8_t));
+		model->SetTileTypes(reinterpret_cast<const uint8_t *>(drawnTypes.data()));
+	}
 
-		unsigned int vertex1 = (int(transform->position.x) & 0xFFFF) | (int(transform->position.y) << 16);
-		unsigned int vertex2 = (int(transform->position.z) & 0xFFFF) | (int(transform->size.x) << 16) | (int(transform->size.y) << 24);
-		return {vertex1, vertex2};
+	std::vector<unsigned int> SlotVertices(size_t first, size_t count) const {
+		std::vector<unsigned int> vertices;
+		vertices.reserve(count * WordsPerTile);
+		for (size_t slot = first; slot < first + count; slot++) {
+			vertices.push_back(PackTile(tiles[slot], drawnTypes[tiles[slot]]));
+		}
+		return vertices;
 	}
 
-	void Update() override {
-		model->Render();
+	// Stage each run of consecutive dirty slots for one upload. Slots past
+	// the end were vacated after being marked and aren't drawn.
+	void StageDirtyRuns() {
+		std::sort(dirtySlots.begin(), dirtySlots.end());
+		dirtySlots.erase(std::unique(dirtySlots.begin(), dirtySlots.end()), dirtySlots.end());
+
+		size_t runStart = 0;
+		for (size_t i = 0; i < dirtySlots.size(); i++) {
+			bool runEnds = i + 1 == dirtySlots.size() || dirtySlots[i + 1] != dirtySlots[i] + 1;
+			if (!runEnds) continue;
+
+			size_t first = dirtySlots[runStart];
+			size_t last = std::min<size_t>(dirtySlots[i] + 1, tiles.size());
+			if (first < last) {
+				stagedRuns.emplace_back(first * WordsPerTile, SlotVertices(first, last - first));
+			}
+			runStart = i + 1;
+		}
+		dirtySlots.clear();
 	}
 };
 
@@ -0,0 +1,428 @@
+#ifndef CHUNK_RESIDENCY_H
+#define CHUNK_RESIDENCY_H
+
+#include "Chunk.hpp"
+#include "MapGenerator.hpp"
+#include "ChunkTiles.hpp"
+#include "../utils/GeneratorSettings.hpp"
+#include "../../engine/utils/glm_hash.hpp"
+#include "../../engine/ecs/components/Camera.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <imgui.h>
+
+struct ResidencySettings {
+	int memoryBudgetMB = 64;	 // Resident chunks
+	int coldCacheBudgetMB = 16;	 // Compressed chunks kept in RAM
+	int keepMargin = 5;			 // Chunks around the view that are never evicted
+	float distanceWeight = 30.0f; // Frames of age one chunk of distance is worth
+	int promotionsPerFrame = 8;	 // Cached chunks decompressed per frame
+	// Each manager spills into a directory of its own under here
+	std::filesystem::path spillRoot = DefaultSpillRoot();
+
+	static std::filesystem::path DefaultSpillRoot() {
+		std::error_code error;
+		std::filesystem::path temp = std::filesystem::temp_directory_path(error);
+		if (error) temp = ".";
+		return temp / "factory-game" / "chunk_cache";
+	}
+
+	void DrawImGui() {
+		ImGui::Text("Residency Settings");
+		IMGUI_FIELD_INT("Memory Budget (MB)", memoryBudgetMB);
+		IMGUI_FIELD_INT("Cold Cache Budget (MB)", coldCacheBudgetMB);
+		IMGUI_FIELD_INT("Keep Margin (chunks)", keepMargin);
+		IMGUI_FIELD_INT("Promotions Per Frame", promotionsPerFrame);
+		ImGui::SliderFloat("Distance Weight", &distanceWeight, 0.0f, 200.0f);
+		memoryBudgetMB = std::max(memoryBudgetMB, 1);
+		coldCacheBudgetMB = std::max(coldCacheBudgetMB, 0);
+		keepMargin = std::max(keepMargin, 0);
+		promotionsPerFrame = std::max(promotionsPerFrame, 1);
+	}
+};
+
+struct ResidencyStats {
+	size_t residentCount = 0;
+	size_t residentBytes = 0;
+	size_t coldCount = 0;
+	size_t coldBytes = 0;
+	size_t spilledCount = 0;
+	size_t spilledBytes = 0;
+	size_t promotedFromCold = 0;
+	size_t promotedFromDisk = 0;
+};
+
+// Chunk tiles in the same palette + bit-packed form they use while resident.
+// Tile types are stored by name so cached chunks survive changes to the
+// TILE_TYPE numbering.
+// Layout, for types then flags: u16 paletteSize, palette entries (types:
+// u8 length + chars, flags: u8), u8 bits, then the packed words as
+// little-endian u64
+namespace ChunkCodec {
+
+inline void WriteWords(std::vector<unsigned char> &data, int bits, const std::vector<uint64_t> &words) {
+	data.push_back(static_cast<unsigned char>(bits));
+	for (uint64_t word : words) {
+		for (int byte = 0; byte < 8; byte++) {
+			data.push_back(static_cast<unsigned char>(word >> (byte * 8)));
+		}
+	}
+}
+
+inline bool ReadWords(const std::vector<unsigned char> &data, size_t &offset, int &bits, std::vector<uint64_t> &words,
+					  size_t (*wordsFor)(int)) {
+	if (offset >= data.size()) return false;
+	bits = data[offset++];
+	if (bits > 8) return false;
+
+	words.assign(wordsFor(bits), 0);
+	if (offset + words.size() * 8 > data.size()) return false;
+	for (auto &word : words) {
+		for (int byte = 0; byte < 8; byte++) {
+			word |= static_cast<uint64_t>(data[offset++]) << (byte * 8);
+		}
+	}
+	return true;
+}
+
+inline void WritePaletteSize(std::vector<unsigned char> &data, size_t size) {
+	data.push_back(size & 0xFF);
+	data.push_back(size >> 8);
+}
+
+inline bool ReadPaletteSize(const std::vector<unsigned char> &data, size_t &offset, size_t &size) {
+	if (offset + 2 > data.size()) return false;
+	size = data[offset] | (data[offset + 1] << 8);
+	offset += 2;
+	return size > 0 && size <= 256;
+}
+
+inline std::vector<unsigned char> Encode(const ChunkTiles &tiles) {
+	std::vector<unsigned char> data;
+
+	const auto &typePalette = tiles.types.GetPalette();
+	WritePaletteSize(data, typePalette.size());
+	for (TILE_TYPE type : typePalette) {
+		std::string name = TileTypeName(type);
+		data.push_back(static_cast<unsigned char>(name.size()));
+		data.insert(data.end(), name.begin(), name.end());
+	}
+	WriteWords(data, tiles.types.GetBits(), tiles.types.GetWords());
+
+	const auto &flagPalette = tiles.flags.GetPalette();
+	WritePaletteSize(data, flagPalette.size());
+	data.insert(data.end(), flagPalette.begin(), flagPalette.end());
+	WriteWords(data, tiles.flags.GetBits(), tiles.flags.GetWords());
+	return data;
+}
+
+inline bool Decode(const std::vector<unsigned char> &data, ChunkTiles &tiles) {
+	size_t offset = 0;
+	size_t paletteSize = 0;
+	int bits = 0;
+	std::vector<uint64_t> words;
+
+	if (!ReadPaletteSize(data, offset, paletteSize)) return false;
+	std::vector<TILE_TYPE> typePalette(paletteSize);
+	for (auto &type : typePalette) {
+		if (offset >= data.size()) return false;
+		size_t length = data[offset++];
+		if (offset + length > data.size()) return false;
+		type = TileTypeFromName(std::string(data.begin() + offset, data.begin() + offset + length));
+		offset += length;
+	}
+	if (!ReadWords(data, offset, bits, words, &decltype(tiles.types)::WordsFor)) return false;
+	if (!tiles.types.Load(std::move(typePalette), bits, std::move(words))) return false;
+
+	if (!ReadPaletteSize(data, offset, paletteSize)) return false;
+	if (offset + paletteSize > data.size()) return false;
+	std::vector<uint8_t> flagPalette(data.begin() + offset, data.begin() + offset + paletteSize);
+	offset += paletteSize;
+	if (!ReadWords(data, offset, bits, words, &decltype(tiles.flags)::WordsFor)) return false;
+	if (!tiles.flags.Load(std::move(flagPalette), bits, std::move(words))) return false;
+
+	// Unknown type names decode as empty and may repeat in the palette
+	tiles.types.Compact();
+	return offset == data.size();
+}
+
+} // namespace ChunkCodec
+
+// Decides which chunks stay decompressed in memory. Chunks evicted from the
+// resident set are compressed into a RAM cold cache, which in turn spills its
+// least recently used entries to disk once it exceeds its own budget.
+//
+// Spill files live in a directory unique to this manager, with a
+// subdirectory per generation that Clear moves on from, so chunks of one map
+// or settings never load as another's. Only that directory is ever removed.
+class ChunkResidencyManager {
+  public:
+	ResidencySettings settings;
+
+	ChunkResidencyManager() : sessionDirectory(settings.spillRoot / SessionName()) {}
+
+	// Files taken but not yet loaded are still in here, so remove it whole
+	~ChunkResidencyManager() {
+		Clear();
+		std::error_code error;
+		std::filesystem::remove_all(sessionDirectory, error);
+	}
+	ChunkResidencyManager(const ChunkResidencyManager &) = delete;
+	ChunkResidencyManager &operator=(const ChunkResidencyManager &) = delete;
+
+	// Record that a resident chunk was needed this frame
+	void Touch(const glm::ivec2 &chunkCoord, uint64_t frame) {
+		auto it = resident.find(chunkCoord);
+		if (it != resident.end()) {
+			it->second.lastTouchedFrame = frame;
+		}
+	}
+
+	void OnResident(const glm::ivec2 &chunkCoord, size_t bytes, uint64_t frame) {
+		auto &info = resident[chunkCoord];
+		residentBytes -= info.bytes;
+		info.bytes = bytes;
+		info.lastTouchedFrame = frame;
+		residentBytes += bytes;
+	}
+
+	void OnRemoved(const glm::ivec2 &chunkCoord) {
+		auto it = resident.find(chunkCoord);
+		if (it == resident.end()) return;
+		residentBytes -= it->second.bytes;
+		resident.erase(it);
+	}
+
+	// Resident chunks that should be evicted to get back under budget, most
+	// evictable first. Chunks inside the half-open keep rect are never chosen.
+	std::vector<glm::ivec2> SelectEvictions(const RectBounds<int> &keepRect, const glm::ivec2 &cameraChunk, uint64_t frame) const {
+		std::vector<glm::ivec2> evictions;
+		size_t budget = static_cast<size_t>(settings.memoryBudgetMB) * 1024 * 1024;
+		if (residentBytes <= budget) return evictions;
+
+		std::vector<std::pair<float, glm::ivec2>> candidates;
+		for (const auto &[coord, info] : resident) {
+			if (coord.x >= keepRect.left && coord.x < keepRect.right &&
+				coord.y >= keepRect.bottom && coord.y < keepRect.top) {
+				continue;
+			}
+
+			int distance = std::max(std::abs(coord.x - cameraChunk.x), std::abs(coord.y - cameraChunk.y));
+			float score = static_cast<float>(frame - info.lastTouchedFrame) + settings.distanceWeight * distance;
+			candidates.push_back({score, coord});
+		}
+
+		std::sort(candidates.begin(), candidates.end(),
+				  [](const auto &a, const auto &b) { return a.first > b.first; });
+
+		size_t projected = residentBytes;
+		for (const auto &[score, coord] : candidates) {
+			if (projected <= budget) break;
+			projected -= resident.at(coord).bytes;
+			evictions.push_back(coord);
+		}
+		return evictions;
+	}
+
+	// Compress an evicted chunk's tiles into the cold cache
+	void Store(const glm::ivec2 &chunkCoord, const ChunkTiles &tiles) {
+		RemoveCold(chunkCoord);
+		RemoveSpilled(chunkCoord);
+
+		coldLru.push_front(chunkCoord);
+		ColdChunk &entry = cold[chunkCoord];
+		entry.data = ChunkCodec::Encode(tiles);
+		entry.lruPosition = coldLru.begin();
+		coldBytes += entry.data.size();
+
+		SpillOverflow();
+	}
+
+	bool IsStored(const glm::ivec2 &chunkCoord) const {
+		return cold.find(chunkCoord) != cold.end() || spilled.find(chunkCoord) != spilled.end();
+	}
+
+	// A cached chunk taken out of the cache for promotion: either its
+	// compressed data or the spill file it still has to be read from
+	struct StoredChunk {
+		std::vector<unsigned char> data;
+		std::string spillPath;
+	};
+
+	// Remove a chunk from the cold cache or disk index so it can be rebuilt.
+	// The chunk becomes resident again when it is re-added.
+	bool Take(const glm::ivec2 &chunkCoord, StoredChunk &stored) {
+		auto coldIt = cold.find(chunkCoord);
+		if (coldIt != cold.end()) {
+			stored.data = std::move(coldIt->second.data);
+			RemoveCold(chunkCoord);
+			stats.promotedFromCold++;
+			return true;
+		}
+
+		auto spilledIt = spilled.find(chunkCoord);
+		if (spilledIt != spilled.end()) {
+			// The file is left for Load to read and delete
+			stored.spillPath = SpillPath(chunkCoord);
+			spilledBytes -= spilledIt->second;
+			spilled.erase(spilledIt);
+			stats.promotedFromDisk++;
+			return true;
+		}
+		return false;
+	}
+
+	// Read and decode a taken chunk. Touches no manager state, so it can run
+	// on a worker thread.
+	static bool Load(const glm::ivec2 &chunkCoord, StoredChunk stored, ChunkTiles &tiles) {
+		if (!stored.spillPath.empty()) {
+			{
+				std::ifstream file(stored.spillPath, std::ios::binary);
+				stored.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			}
+			std::error_code error;
+			std::filesystem::remove(stored.spillPath, error);
+		}
+
+		if (!ChunkCodec::Decode(stored.data, tiles)) {
+			printf("Failed to decode cached chunk (%d, %d), regenerating\n", chunkCoord.x, chunkCoord.y);
+			return false;
+		}
+		return true;
+	}
+
+	// Drop everything, e.g. when the generator settings change
+	void Clear() {
+		resident.clear();
+		residentBytes = 0;
+		cold.clear();
+		coldLru.clear();
+		coldBytes = 0;
+		std::error_code error;
+		for (const auto &[coord, bytes] : spilled) {
+			std::filesystem::remove(SpillPath(coord), error);
+		}
+		spilled.clear();
+		spilledBytes = 0;
+		// Only removed once empty; files still being promoted remove themselves
+		std::filesystem::remove(SpillDirectory(), error);
+		generation++;
+	}
+
+	ResidencyStats GetStats() const {
+		ResidencyStats result = stats;
+		result.residentCount = resident.size();
+		result.residentBytes = residentBytes;
+		result.coldCount = cold.size();
+		result.coldBytes = coldBytes;
+		result.spilledCount = spilled.size();
+		result.spilledBytes = spilledBytes;
+		return result;
+	}
+
+	void DrawImGui() {
+		settings.DrawImGui();
+
+		ResidencyStats current = GetStats();
+		ImGui::Text("Residency Stats:");
+		ImGui::Text("Resident: %zu (%.2f MB)", current.residentCount, current.residentBytes / (1024.0 * 1024.0));
+		ImGui::Text("Cold: %zu (%.2f MB)", current.coldCount, current.coldBytes / (1024.0 * 1024.0));
+		ImGui::Text("Spilled: %zu (%.2f MB)", current.spilledCount, current.spilledBytes / (1024.0 * 1024.0));
+		ImGui::Text("Promoted: %zu cold, %zu disk", current.promotedFromCold, current.promotedFromDisk);
+	}
+
+  private:
+	struct ResidentInfo {
+		size_t bytes = 0;
+		uint64_t lastTouchedFrame = 0;
+	};
+
+	struct ColdChunk {
+		std::vector<unsigned char> data;
+		std::list<glm::ivec2>::iterator lruPosition;
+	};
+
+	std::unordered_map<glm::ivec2, ResidentInfo> resident;
+	size_t residentBytes = 0;
+
+	// Most recently stored at the front
+	std::list<glm::ivec2> coldLru;
+	std::unordered_map<glm::ivec2, ColdChunk> cold;
+	size_t coldBytes = 0;
+
+	std::unordered_map<glm::ivec2, size_t> spilled;
+	size_t spilledBytes = 0;
+
+	ResidencyStats stats;
+
+	std::filesystem::path sessionDirectory;
+	uint64_t generation = 0; // Bumped by Clear
+
+	// Time plus a random number, so concurrent runs don't share a directory
+	static std::string SessionName() {
+		auto now = std::chrono::system_clock::now().time_since_epoch();
+		return "session-" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now).count()) + "-" +
+			   std::to_string(std::random_device{}());
+	}
+
+	std::filesystem::path SpillDirectory() const {
+		return sessionDirectory / ("generation-" + std::to_string(generation));
+	}
+
+	std::string SpillPath(const glm::ivec2 &chunkCoord) const {
+		std::string name = std::to_string(chunkCoord.x) + "_" + std::to_string(chunkCoord.y) + ".chunk";
+		return (SpillDirectory() / name).string();
+	}
+
+	void RemoveCold(const glm::ivec2 &chunkCoord) {
+		auto it = cold.find(chunkCoord);
+		if (it == cold.end()) return;
+		coldBytes -= it->second.data.size();
+		coldLru.erase(it->second.lruPosition);
+		cold.erase(it);
+	}
+
+	void RemoveSpilled(const glm::ivec2 &chunkCoord) {
+		auto it = spilled.find(chunkCoord);
+		if (it == spilled.end()) return;
+		std::error_code error;
+		std::filesystem::remove(SpillPath(chunkCoord), error);
+		spilledBytes -= it->second;
+		spilled.erase(it);
+	}
+
+	// Write least recently stored cold chunks to disk until under budget
+	void SpillOverflow() {
+		size_t budget = static_cast<size_t>(settings.coldCacheBudgetMB) * 1024 * 1024;
+		if (coldBytes <= budget) return;
+
+		std::error_code error;
+		std::filesystem::create_directories(SpillDirectory(), error);
+
+		while (coldBytes > budget && !coldLru.empty()) {
+			glm::ivec2 coord = coldLru.back();
+			ColdChunk &entry = cold.at(coord);
+
+			std::ofstream file(SpillPath(coord), std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char *>(entry.data.data()), entry.data.size());
+			if (file) {
+				spilled[coord] = entry.data.size();
+				spilledBytes += entry.data.size();
+			} else {
+				printf("Failed to spill chunk (%d, %d) to disk, dropping it\n", coord.x, coord.y);
+			}
+			RemoveCold(coord);
+		}
+	}
+};
+
+#endif
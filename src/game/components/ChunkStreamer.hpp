@@ -0,0 +1,110 @@
+#ifndef CHUNK_STREAMER_H
+#define CHUNK_STREAMER_H
+
+#include "../../engine/ecs/components/Camera.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <glm/ext/vector_int2.hpp>
+#include <utility>
+#include <vector>
+
+// Chunks that entered or left the desired set since the last view change.
+// Added chunks are sorted by priority, highest first.
+struct StreamingDelta {
+	std::vector<std::pair<glm::ivec2, int>> added;
+	std::vector<glm::ivec2> removed;
+
+	bool Empty() const { return added.empty() && removed.empty(); }
+};
+
+// Tracks the set of chunks the map wants loaded. The set is two rectangles
+// derived from the view: chunks are requested once they enter the load rect
+// (view + loadBuffer) and released once they leave the keep rect
+// (view + keepMargin), so small camera moves don't thrash chunks.
+// Nothing is recomputed until the view crosses a chunk boundary or the zoom
+// changes the visible chunk range.
+class ChunkStreamer {
+  public:
+	int loadBuffer = 2;
+	int keepMargin = 5;
+
+	// Compare the current view against the last one and return the changes.
+	// Returns an empty delta while the chunk-space view is unchanged.
+	StreamingDelta Update(const RectBounds<int> &view, const glm::ivec2 &cameraChunk) {
+		StreamingDelta delta;
+
+		RectBounds<int> newLoad = Expand(view, loadBuffer);
+		RectBounds<int> newKeep = Expand(view, std::max(keepMargin, loadBuffer));
+
+		if (hasView && SameRect(newLoad, loadRect) && SameRect(newKeep, keepRect)) {
+			return delta;
+		}
+
+		for (int y = newLoad.bottom; y < newLoad.top; y++) {
+			for (int x = newLoad.left; x < newLoad.right; x++) {
+				if (hasView && Contains(loadRect, x, y)) continue;
+
+				// Higher priority for closer chunks
+				int distance = std::abs(x - cameraChunk.x) + std::abs(y - cameraChunk.y);
+				delta.added.push_back({glm::ivec2(x, y), 100 - distance});
+			}
+		}
+
+		if (hasView) {
+			for (int y = keepRect.bottom; y < keepRect.top; y++) {
+				for (int x = keepRect.left; x < keepRect.right; x++) {
+					if (!Contains(newKeep, x, y)) {
+						delta.removed.push_back(glm::ivec2(x, y));
+					}
+				}
+			}
+		}
+
+		std::sort(delta.added.begin(), delta.added.end(),
+				  [](const auto &a, const auto &b) { return a.second > b.second; });
+
+		loadRect = newLoad;
+		keepRect = newKeep;
+		hasView = true;
+		changes++;
+		return delta;
+	}
+
+	// Forget the previous view so the next update re-emits the whole load rect
+	void Reset() {
+		hasView = false;
+	}
+
+	bool ShouldLoad(const glm::ivec2 &chunkCoord) const {
+		return hasView && Contains(loadRect, chunkCoord.x, chunkCoord.y);
+	}
+
+	bool ShouldKeep(const glm::ivec2 &chunkCoord) const {
+		return hasView && Contains(keepRect, chunkCoord.x, chunkCoord.y);
+	}
+
+	const RectBounds<int> &GetLoadRect() const { return loadRect; }
+	const RectBounds<int> &GetKeepRect() const { return keepRect; }
+	size_t GetChangeCount() const { return changes; }
+
+  private:
+	RectBounds<int> loadRect = {0, 0, 0, 0};
+	RectBounds<int> keepRect = {0, 0, 0, 0};
+	bool hasView = false;
+	size_t changes = 0;
+
+	// Chunk rects are half-open: [left, right) x [bottom, top)
+	static bool Contains(const RectBounds<int> &rect, int x, int y) {
+		return x >= rect.left && x < rect.right && y >= rect.bottom && y < rect.top;
+	}
+
+	static bool SameRect(const RectBounds<int> &a, const RectBounds<int> &b) {
+		return a.top == b.top && a.left == b.left && a.bottom == b.bottom && a.right == b.right;
+	}
+
+	static RectBounds<int> Expand(const RectBounds<int> &rect, int amount) {
+		return {rect.top + amount, rect.left - amount, rect.bottom - amount, rect.right + amount};
+	}
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef CHUNK_SUMMARY_H
+#define CHUNK_SUMMARY_H
+
+#include "ChunkTiles.hpp"
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <glm/common.hpp>
+#include <glm/ext/vector_int2.hpp>
+
+inline bool IsOreTile(TILE_TYPE type) {
+	return type == TILE_IRON_ORE || type == TILE_COPPER_ORE || type == TILE_COAL_ORE || type == TILE_GOLD_ORE;
+}
+
+// Ore units in a tile of average richness; zero for everything else
+inline uint32_t OreBaseAmount(TILE_TYPE type) {
+	switch (type) {
+	case TILE_IRON_ORE:
+	case TILE_COPPER_ORE:
+	case TILE_COAL_ORE:
+		return 500;
+	case TILE_GOLD_ORE:
+		return 200;
+	default:
+		return 0;
+	}
+}
+
+// Tiles of one type within a chunk or a region of chunks
+struct ResourceTotal {
+	uint32_t tiles = 0;
+	uint64_t amount = 0; // Ore units left
+	// Inclusive world tile bounds, valid while tiles > 0. Removing tiles
+	// doesn't shrink them, so they may over-cover after edits.
+	glm::ivec2 min = glm::ivec2(INT_MAX);
+	glm::ivec2 max = glm::ivec2(INT_MIN);
+	// Most tiles in any one chunk below, for totals over several chunks
+	uint32_t chunkPeak = 0;
+
+	void AddTile(glm::ivec2 tile, uint64_t tileAmount) {
+		tiles++;
+		amount += tileAmount;
+		min = glm::min(min, tile);
+		max = glm::max(max, tile);
+	}
+
+	// Remove one tile whose own amount isn't known, taking an even share
+	void RemoveTile() {
+		if (tiles == 0) return;
+		amount -= amount / tiles;
+		if (--tiles == 0) {
+			*this = ResourceTotal();
+		}
+	}
+
+	void Merge(const ResourceTotal &other) {
+		if (other.tiles == 0) return;
+		tiles += other.tiles;
+		amount += other.amount;
+		min = glm::min(min, other.min);
+		max = glm::max(max, other.max);
+	}
+
+	// Squared distance from a tile to the bounds, 0 inside
+	int64_t DistanceSquared(glm::ivec2 tile) const {
+		int64_t dx = std::max<int64_t>({int64_t(min.x) - tile.x, 0, int64_t(tile.x) - max.x});
+		int64_t dy = std::max<int64_t>({int64_t(min.y) - tile.y, 0, int64_t(tile.y) - max.y});
+		return dx * dx + dy * dy;
+	}
+};
+
+using ResourceTotals = std::array<ResourceTotal, TILE_TYPE_COUNT>;
+
+// Per-type tile counts, ore amounts and bounds of one chunk, kept up to date
+// as tiles change so resource queries never have to read tiles
+struct ChunkSummary {
+	ResourceTotals types;
+
+	const ResourceTotal &operator[](TILE_TYPE type) const { return types[type]; }
+
+	void AddTile(glm::ivec2 tile, TILE_TYPE type, uint64_t amount) {
+		if (type == TILE_EMPTY) return;
+		types[type].AddTile(tile, amount);
+	}
+
+	void OnTileChanged(glm::ivec2 tile, TILE_TYPE from, TILE_TYPE to) {
+		if (from == to) return;
+		if (from != TILE_EMPTY) types[from].RemoveTile();
+		AddTile(tile, to, OreBaseAmount(to));
+	}
+
+	// Summary of tiles that don't carry their generated ore amounts, e.g.
+	// ones decoded from the cache without an indexed summary
+	static ChunkSummary FromTiles(glm::ivec2 chunkCoord, const ChunkTiles &tiles) {
+		ChunkSummary summary;
+		glm::ivec2 origin = chunkCoord * CHUNK_SIZE;
+		tiles.types.ForEach([&](size_t index, TILE_TYPE type) {
+			summary.AddTile(origin + ChunkTiles::LocalPosition(static_cast<int>(index)), type, OreBaseAmount(type));
+		});
+		return summary;
+	}
+};
+
+#endif
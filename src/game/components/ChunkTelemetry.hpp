@@ -0,0 +1,177 @@
+#ifndef CHUNK_TELEMETRY_H
+#define CHUNK_TELEMETRY_H
+
+#include "../../engine/async/Scheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <glm/ext/vector_int2.hpp>
+#include <imgui.h>
+
+using TelemetryClock = std::chrono::steady_clock;
+
+// Timestamps for one chunk request as it moves through the pipeline:
+// queued -> picked up by a worker -> generated -> collected by the main
+// thread -> integrated into the map
+struct ChunkRequestTiming {
+	glm::ivec2 chunkCoord = glm::ivec2(0, 0);
+	int worker = -1;
+	TelemetryClock::time_point requested;
+	TelemetryClock::time_point dequeued;
+	TelemetryClock::time_point generated;
+	TelemetryClock::time_point collected;
+	TelemetryClock::time_point integrated;
+
+	static double Ms(TelemetryClock::time_point from, TelemetryClock::time_point to) {
+		return std::chrono::duration<double, std::milli>(to - from).count();
+	}
+
+	double QueueWaitMs() const { return Ms(requested, dequeued); }
+	double GenerationMs() const { return Ms(dequeued, generated); }
+	double ResultWaitMs() const { return Ms(generated, collected); }
+	double IntegrationMs() const { return Ms(collected, integrated); }
+};
+
+struct LatencyPercentiles {
+	double p50 = 0.0;
+	double p95 = 0.0;
+	double p99 = 0.0;
+};
+
+// Collects chunk pipeline latencies. Everything is recorded from the main
+// thread; worker utilisation comes from the shared thread pool.
+class ChunkTelemetry {
+  public:
+	static constexpr size_t MaxSamples = 4096;
+
+	void RecordCancelled() { cancelled++; }
+	void RecordWasted() { wasted++; }
+	void RecordCompleted(const ChunkRequestTiming &timing) {
+		samples.push_back(timing);
+		if (samples.size() > MaxSamples) {
+			samples.pop_front();
+		}
+	}
+
+	size_t GetCancelled() const { return cancelled; }
+	size_t GetWasted() const { return wasted; }
+
+	template <typename Metric>
+	LatencyPercentiles Percentiles(Metric metric) const {
+		LatencyPercentiles result;
+		if (samples.empty()) return result;
+
+		std::vector<double> values;
+		values.reserve(samples.size());
+		for (const auto &sample : samples) {
+			values.push_back((sample.*metric)());
+		}
+		std::sort(values.begin(), values.end());
+
+		auto at = [&](double percentile) {
+			size_t index = static_cast<size_t>(percentile * (values.size() - 1) + 0.5);
+			return values[index];
+		};
+		result.p50 = at(0.50);
+		result.p95 = at(0.95);
+		result.p99 = at(0.99);
+		return result;
+	}
+
+	void Reset() {
+		samples.clear();
+		cancelled = 0;
+		wasted = 0;
+		Async::Pool().ResetWorkerStats();
+	}
+
+	void DrawImGui() {
+		ImGui::Text("Request Latency (last %zu, ms):", samples.size());
+		if (ImGui::BeginTable("ChunkLatency", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+			ImGui::TableSetupColumn("Stage");
+			ImGui::TableSetupColumn("p50");
+			ImGui::TableSetupColumn("p95");
+			ImGui::TableSetupColumn("p99");
+			ImGui::TableHeadersRow();
+
+			DrawLatencyRow("Queue Wait", Percentiles(&ChunkRequestTiming::QueueWaitMs));
+			DrawLatencyRow("Generation", Percentiles(&ChunkRequestTiming::GenerationMs));
+			DrawLatencyRow("Result Wait", Percentiles(&ChunkRequestTiming::ResultWaitMs));
+			DrawLatencyRow("Integration", Percentiles(&ChunkRequestTiming::IntegrationMs));
+			ImGui::EndTable();
+		}
+
+		ImGui::Text("Cancelled: %zu  Wasted: %zu", GetCancelled(), GetWasted());
+
+		ImGui::Text("Workers:");
+		std::vector<Async::WorkerStats> workers = Async::Pool().GetWorkerStats();
+		for (size_t i = 0; i < workers.size(); i++) {
+			double busy = static_cast<double>(workers[i].busyNs);
+			double idle = static_cast<double>(workers[i].idleNs);
+			double ratio = busy + idle > 0.0 ? busy / (busy + idle) : 0.0;
+			ImGui::Text("  #%zu busy %5.1f%% idle %5.1f%% jobs %zu", i, ratio * 100.0,
+						busy + idle > 0.0 ? 100.0 - ratio * 100.0 : 0.0, workers[i].jobs);
+		}
+
+		if (ImGui::Button("Export CSV")) {
+			if (ExportCsv("chunk_requests.csv", "chunk_workers.csv")) {
+				printf("Chunk telemetry written to chunk_requests.csv and chunk_workers.csv\n");
+			}
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Reset Telemetry")) {
+			Reset();
+		}
+	}
+
+	bool ExportCsv(const std::string &requestsPath, const std::string &workersPath) const {
+		std::ofstream requests(requestsPath);
+		std::ofstream workerFile(workersPath);
+		if (!requests || !workerFile) {
+			printf("Failed to open telemetry CSV files for writing\n");
+			return false;
+		}
+
+		requests << "chunk_x,chunk_y,worker,queue_wait_ms,generation_ms,result_wait_ms,integration_ms\n";
+		for (const auto &sample : samples) {
+			requests << sample.chunkCoord.x << "," << sample.chunkCoord.y << "," << sample.worker << ","
+					 << sample.QueueWaitMs() << "," << sample.GenerationMs() << ","
+					 << sample.ResultWaitMs() << "," << sample.IntegrationMs() << "\n";
+		}
+
+		workerFile << "worker,busy_ms,idle_ms,busy_ratio,jobs,cancelled,wasted\n";
+		std::vector<Async::WorkerStats> workers = Async::Pool().GetWorkerStats();
+		for (size_t i = 0; i < workers.size(); i++) {
+			double busy = workers[i].busyNs / 1e6;
+			double idle = workers[i].idleNs / 1e6;
+			workerFile << i << "," << busy << "," << idle << ","
+					   << (busy + idle > 0.0 ? busy / (busy + idle) : 0.0) << ","
+					   << workers[i].jobs << "," << GetCancelled() << "," << GetWasted() << "\n";
+		}
+		return true;
+	}
+
+  private:
+	size_t cancelled = 0;
+	size_t wasted = 0;
+	std::deque<ChunkRequestTiming> samples;
+
+	static void DrawLatencyRow(const char *label, const LatencyPercentiles &latency) {
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(label);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.2f", latency.p50);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.2f", latency.p95);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.2f", latency.p99);
+	}
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef CHUNK_TILES_H
+#define CHUNK_TILES_H
+
+#include "../../engine/utils/PalettedArray.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <glm/ext/vector_int2.hpp>
+
+#define CHUNK_SIZE 32
+#define CHUNK_AREA (CHUNK_SIZE * CHUNK_SIZE)
+
+// Terrain tile types. The names double as texture names.
+enum TILE_TYPE : uint8_t {
+	TILE_EMPTY,
+	TILE_GRASS_1,
+	TILE_GRASS_2,
+	TILE_TREE,
+	TILE_WATER,
+	TILE_SAND,
+	TILE_SAND_DUNE,
+	TILE_STONE,
+	TILE_MOUNTAIN,
+	TILE_ROCK,
+	TILE_MUD,
+	TILE_SWAMP_WATER,
+	TILE_IRON_ORE,
+	TILE_COPPER_ORE,
+	TILE_COAL_ORE,
+	TILE_GOLD_ORE,
+	TILE_TYPE_COUNT
+};
+
+enum TILE_FLAG : uint8_t {
+	TILE_FLAG_NONE = 0,
+	TILE_FLAG_BUILDING = 1 << 0, // A building entity occupies this tile
+};
+
+inline const char *TileTypeName(TILE_TYPE type) {
+	static const char *names[TILE_TYPE_COUNT] = {
+		"",
+		"GRASS_TILE_1",
+		"GRASS_TILE_2",
+		"TREE_TILE",
+		"WATER_TILE",
+		"SAND_TILE",
+		"SAND_DUNE_TILE",
+		"STONE_TILE",
+		"MOUNTAIN_TILE",
+		"ROCK_TILE",
+		"MUD_TILE",
+		"SWAMP_WATER_TILE",
+		"IRON_ORE_TILE",
+		"COPPER_ORE_TILE",
+		"COAL_ORE_TILE",
+		"GOLD_ORE_TILE",
+	};
+	return type < TILE_TYPE_COUNT ? names[type] : "";
+}
+
+// TILE_EMPTY for unknown names
+inline TILE_TYPE TileTypeFromName(const std::string &name) {
+	for (int type = TILE_EMPTY + 1; type < TILE_TYPE_COUNT; type++) {
+		if (name == TileTypeName(static_cast<TILE_TYPE>(type))) {
+			return static_cast<TILE_TYPE>(type);
+		}
+	}
+	return TILE_EMPTY;
+}
+
+// Terrain of one chunk indexed by local position, row-major. Types and flags
+// are palette compressed, so a chunk of a few tile types costs a few hundred
+// bytes. Anything richer lives in a building entity.
+struct ChunkTiles {
+	PalettedArray<TILE_TYPE, CHUNK_AREA> types;
+	PalettedArray<uint8_t, CHUNK_AREA> flags;
+
+	static int Index(int localX, int localY) { return localY * CHUNK_SIZE + localX; }
+	static glm::ivec2 LocalPosition(int index) { return glm::ivec2(index % CHUNK_SIZE, index / CHUNK_SIZE); }
+
+	TILE_TYPE GetType(int index) const { return types.Get(index); }
+	TILE_TYPE GetType(int localX, int localY) const { return types.Get(Index(localX, localY)); }
+	void SetType(int index, TILE_TYPE type) { types.Set(index, type); }
+	void SetType(int localX, int localY, TILE_TYPE type) { types.Set(Index(localX, localY), type); }
+
+	bool HasFlag(int index, TILE_FLAG flag) const { return (flags.Get(index) & flag) != 0; }
+	void SetFlag(int index, TILE_FLAG flag, bool value) {
+		uint8_t current = flags.Get(index);
+		flags.Set(index, value ? (current | flag) : (current & ~flag));
+	}
+
+	// Shrink both arrays to the narrowest encoding, e.g. after generation
+	void Compact() {
+		types.Compact();
+		flags.Compact();
+	}
+
+	// Non-empty tiles
+	size_t Count() const {
+		size_t count = 0;
+		types.ForEach([&](size_t, TILE_TYPE type) { count += type != TILE_EMPTY; });
+		return count;
+	}
+
+	size_t HeapBytes() const { return types.HeapBytes() + flags.HeapBytes(); }
+};
+
+#endif
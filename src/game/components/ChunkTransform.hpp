@@ -7,8 +7,8 @@
 
 struct ChunkTransform : IComponent {
 	glm::ivec2 position = glm::ivec2(0, 0);
-	ChunkTransform() {};
-	ChunkTransform(glm::ivec2 position) : position(position) {};
+	ChunkTransform() { Sleep(); };
+	ChunkTransform(glm::ivec2 position) : position(position) { Sleep(); };
 };
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef MAP_H
 #define MAP_H
 
+#include "../../engine/async/Task.hpp"
 #include "../../engine/ecs/IComponent.hpp"
 #include "../../engine/ecs/Entity.hpp"
 #include "Chunk.hpp"
@@ -9,14 +10,13 @@
 #include "../../engine/Simplex.hpp"
 #include "../../engine/ecs/components/Camera.hpp"
 #include <glm/ext/vector_float2.hpp>
-#include <unordered_map>
 #include <utility>
-#include "../../engine/utils/glm_hash.hpp"
+#include "../../engine/utils/ChunkMap.hpp"
 #include <imgui.h>
 #include <imgui_stdlib.h>
 
 struct Map : IComponent {
-	std::unordered_map<glm::ivec2, Entity *> chunks;
+	ChunkMap<Entity *> chunks;
 	GeneratorSettings settings;
 
 	Map() {};
@@ -24,21 +24,6 @@ struct Map : IComponent {
 	void Start() override {
 	}
 
-	void GenerateLODS() {
-		RectBounds<int> chunkCoords = CalculateChunksInView();
-		return;
-
-		for (int y = chunkCoords.bottom - 10; y < chunkCoords.top + 10; y++) {
-			for (int x = chunkCoords.left - 10; x < chunkCoords.right + 10; x++) {
-				glm::ivec2 chunkCoord = glm::ivec2(x, y);
-				Entity *chunk = chunks[chunkCoord];
-				if (chunk != nullptr) {
-					chunk->GetComponent<Chunk>()->Generate(settings);
-				}
-			}
-		}
-	};
-
 	void GenerateChunks() {
 		RectBounds<int> chunkCoords = CalculateChunksInView();
 
@@ -58,8 +43,9 @@ struct Map : IComponent {
 				}
 
 				Entity *chunk = chunks[chunkCoord];
-				if (chunkCoords.InBounds(chunkCoord.x, chunkCoord.y) && !chunk->GetComponent<Chunk>()->Generated) {
-					chunk->GetComponent<Chunk>()->Generate(settings);
+				Chunk *chunkComponent = chunk->GetComponent<Chunk>();
+				if (chunkCoords.InBounds(chunkCoord.x, chunkCoord.y) && !chunkComponent->Generated && !chunkComponent->Generating) {
+					Async::Spawn(chunkComponent->Generate(settings));
 				}
 			}
 		}
@@ -72,9 +58,9 @@ struct Map : IComponent {
 
 			if ((chunkCoord.x < chunkCoords.left - 10 || chunkCoord.x >= chunkCoords.right + 10 ||
 				 chunkCoord.y < chunkCoords.bottom - 10 || chunkCoord.y >= chunkCoords.top + 10) &&
-				chunks.size() > 1000) {
+				chunks.size() > 1000 && !it->second->GetComponent<Chunk>()->Generating) {
 
-				delete it->second;
+				it->second->Destroy();
 				it = chunks.erase(it);
 			} else {
 				++it;
@@ -83,7 +69,7 @@ struct Map : IComponent {
 	}
 
 	RectBounds<int> CalculateChunksInView() {
-		RectBounds<float> cameraBounds = Simplex::view.Camera->GetComponent<Camera>()->GetCameraBounds();
+		RectBounds<float> cameraBounds = Simplex::view.GetCamera()->GetComponent<Camera>()->GetCameraBounds();
 		int chunkXStart = static_cast<int>(std::floor(cameraBounds.left / settings.chunkSize));
 		int chunkXEnd = static_cast<int>(std::floor(cameraBounds.right / settings.chunkSize));
 		int chunkYStart = static_cast<int>(std::floor(cameraBounds.top / settings.chunkSize));
@@ -110,7 +96,9 @@ struct Map : IComponent {
 		CullChunks();
 		for (auto chunk : chunks) {
 			chunk.second->UpdateComponents();
+			chunk.second->GetComponent<ChunkRenderer>()->Render();
 		}
+		ChunkRenderer::DrawQueued();
 	};
 };
 
@@ -12,12 +12,12 @@
 #include <queue>
 #include <vector>
 #include "../utils/GeneratorSettings.hpp"
-#include "../entities/TileEntity.hpp"
+#include "ChunkSummary.hpp"
+#include "ChunkTiles.hpp"
 #include <random>
 #include <mutex>
 #include <atomic>
 
-#define CHUNK_SIZE 32
 #define maxPrimeIndex 10
 
 struct OrePatch {
@@ -40,9 +40,18 @@ struct BiomeInfo {
 class MapGenerator {
 
   public:
-	static std::vector<TileEntity *> Generate(int chunkX = 0, int chunkY = 0, GeneratorSettings settings = {}) {
-		std::vector<TileEntity *> tiles;
-		std::unordered_map<glm::ivec2, std::string> tileMap;
+	// Fills summary, if given, with the chunk's resource totals including the
+	// ore amounts placed by each patch
+	static ChunkTiles Generate(int chunkX = 0, int chunkY = 0, GeneratorSettings settings = {}, ChunkSummary *summary = nullptr) {
+		std::vector<std::string> terrain = GenerateTerrainRows(chunkX, chunkY, 0, CHUNK_SIZE, settings);
+		return Finalize(chunkX, chunkY, terrain, settings, summary);
+	}
+
+	// Base terrain for local rows [rowBegin, rowEnd) of a chunk, row-major.
+	// Rows don't depend on each other, so one chunk can be split across threads.
+	static std::vector<std::string> GenerateTerrainRows(int chunkX, int chunkY, int rowBegin, int rowEnd, GeneratorSettings settings) {
+		std::vector<std::string> terrain;
+		terrain.reserve((rowEnd - rowBegin) * CHUNK_SIZE);
 
 		int startX = chunkX * CHUNK_SIZE;
 		int startY = chunkY * CHUNK_SIZE;
@@ -51,10 +60,30 @@ class MapGenerator {
 		InitializeBiomes();
 
 		// --- Step 1: Generate base terrain with biomes
-		for (int y = startY; y < startY + CHUNK_SIZE; y++) {
+		for (int y = startY + rowBegin; y < startY + rowEnd; y++) {
 			for (int x = startX; x < startX + CHUNK_SIZE; x++) {
-				std::string tileId = GenerateTerrainTile(x, y, settings);
-				tileMap[glm::ivec2(x, y)] = tileId;
+				terrain.push_back(GenerateTerrainTile(x, y, settings));
+			}
+		}
+
+		return terrain;
+	}
+
+	// Places ores and details over a chunk's full base terrain and builds its tiles
+	static ChunkTiles Finalize(int chunkX, int chunkY, const std::vector<std::string> &terrain, GeneratorSettings settings,
+							   ChunkSummary *summary = nullptr) {
+		ChunkTiles tiles;
+		std::unordered_map<glm::ivec2, std::string> tileMap;
+		std::unordered_map<glm::ivec2, uint32_t> oreAmounts;
+
+		int startX = chunkX * CHUNK_SIZE;
+		int startY = chunkY * CHUNK_SIZE;
+
+		InitializeBiomes();
+
+		for (int y = 0; y < CHUNK_SIZE; y++) {
+			for (int x = 0; x < CHUNK_SIZE; x++) {
+				tileMap[glm::ivec2(startX + x, startY + y)] = terrain[y * CHUNK_SIZE + x];
 			}
 		}
 
@@ -63,17 +92,25 @@ class MapGenerator {
 
 		// Place ore patches
 		for (const auto &patch : orePatches) {
-			PlaceOrePatch(patch, tileMap);
+			PlaceOrePatch(patch, tileMap, oreAmounts);
 		}
 
 		// --- Step 3: Post-process for variety and smoothing
 		PostProcessTerrain(tileMap, startX, startY, settings);
 
-		// --- Step 4: Create TileEntities
+		// --- Step 4: Pack into the chunk's tile arrays
 		for (const auto &[pos, id] : tileMap) {
-			TileEntity *tile = new TileEntity(glm::ivec3(pos.x, pos.y, 0), id);
-			tiles.push_back(tile);
+			TILE_TYPE type = TileTypeFromName(id);
+			tiles.SetType(pos.x - startX, pos.y - startY, type);
+
+			if (summary) {
+				// Gaps filled during cleanup have no amount of their own
+				auto amount = oreAmounts.find(pos);
+				bool placed = IsOreTile(type) && amount != oreAmounts.end();
+				summary->AddTile(pos, type, placed ? amount->second : OreBaseAmount(type));
+			}
 		}
+		tiles.Compact();
 
 		return tiles;
 	}
@@ -285,7 +322,9 @@ class MapGenerator {
 		return patches;
 	}
 
-	static void PlaceOrePatch(const OrePatch &patch, std::unordered_map<glm::ivec2, std::string> &tileMap) {
+	// Ore amounts per placed tile go into oreAmounts, richer towards the core
+	static void PlaceOrePatch(const OrePatch &patch, std::unordered_map<glm::ivec2, std::string> &tileMap,
+							  std::unordered_map<glm::ivec2, uint32_t> &oreAmounts) {
 		// Use noise-based generation for more natural, solid ore patches
 		// Create a new RNG instance for each patch to avoid shared state
 		std::mt19937 rng(patch.center.x * 73856093 + patch.center.y * 19349663);
@@ -351,6 +390,8 @@ class MapGenerator {
 					auto it = tileMap.find(pos);
 					if (it != tileMap.end() && it->second != "WATER_TILE") {
 						tileMap[pos] = patch.type;
+						float falloff = 1.5f - distortedDistance / float(patch.radius);
+						oreAmounts[pos] = static_cast<uint32_t>(OreBaseAmount(TileTypeFromName(patch.type)) * patch.richness * falloff);
 					}
 				}
 			}
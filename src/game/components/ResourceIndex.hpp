@@ -0,0 +1,193 @@
+#ifndef RESOURCE_INDEX_H
+#define RESOURCE_INDEX_H
+
+#include "ChunkSummary.hpp"
+#include "../../engine/utils/ChunkMap.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+#include <glm/ext/vector_int2.hpp>
+
+// Result of a nearest resource query. The region is an aligned block of
+// chunks, [chunkMin, chunkMax), a single chunk when one chunk is enough.
+struct ResourceHit {
+	bool found = false;
+	int level = 0;
+	glm::ivec2 chunkMin = glm::ivec2(0);
+	glm::ivec2 chunkMax = glm::ivec2(0);
+	ResourceTotal total;
+};
+
+// Quadtree of chunk summaries over every chunk generated so far, resident or
+// cached. Level 0 holds the chunks themselves; a node at level L covers the
+// 2^L x 2^L chunks whose coordinates share their bits above L, and holds the
+// merged totals of its four children. Updating a chunk touches one node per
+// level, and queries descend only into nodes that can still contribute.
+class ResourceIndex {
+  public:
+	static constexpr int TopLevel = 15;
+
+	void Set(const glm::ivec2 &chunkCoord, const ChunkSummary &summary) {
+		levels[0][chunkCoord] = summary.types;
+		UpdateAncestors(chunkCoord);
+	}
+
+	void Remove(const glm::ivec2 &chunkCoord) {
+		if (levels[0].erase(chunkCoord)) {
+			UpdateAncestors(chunkCoord);
+		}
+	}
+
+	// Indexed summary of a chunk, or false if it was never indexed
+	bool Get(const glm::ivec2 &chunkCoord, ChunkSummary &summary) const {
+		const ResourceTotals *totals = levels[0].Find(chunkCoord);
+		if (!totals) return false;
+		summary.types = *totals;
+		return true;
+	}
+
+	void Clear() {
+		for (auto &level : levels) {
+			level.clear();
+		}
+	}
+
+	size_t GetChunkCount() const { return levels[0].size(); }
+
+	// Totals of one type over the chunks in [chunkMin, chunkMax)
+	ResourceTotal RegionTotal(TILE_TYPE type, glm::ivec2 chunkMin, glm::ivec2 chunkMax) const {
+		ResourceTotal total;
+		if (chunkMin.x >= chunkMax.x || chunkMin.y >= chunkMax.y) return total;
+
+		glm::ivec2 topMin(chunkMin.x >> TopLevel, chunkMin.y >> TopLevel);
+		glm::ivec2 topMax((chunkMax.x - 1) >> TopLevel, (chunkMax.y - 1) >> TopLevel);
+		for (int y = topMin.y; y <= topMax.y; y++) {
+			for (int x = topMin.x; x <= topMax.x; x++) {
+				Accumulate(type, TopLevel, glm::ivec2(x, y), chunkMin, chunkMax, total);
+			}
+		}
+		return total;
+	}
+
+	// Nearest region to a world tile holding at least minTiles tiles of a
+	// type, measured to the type's bounds. That is the nearest single chunk
+	// if any chunk holds enough; otherwise the smallest aligned block of
+	// chunks that does together.
+	ResourceHit FindNearest(TILE_TYPE type, glm::ivec2 fromTile, uint32_t minTiles) const {
+		minTiles = std::max<uint32_t>(minTiles, 1);
+		ResourceHit hit = Search(type, fromTile, [&](int level, const ResourceTotal &total) {
+			return (level == 0 ? total.tiles : total.chunkPeak) >= minTiles;
+		});
+		if (hit.found) return hit;
+		return Search(type, fromTile, [&](int, const ResourceTotal &total) { return total.tiles >= minTiles; });
+	}
+
+  private:
+	std::array<ChunkMap<ResourceTotals>, TopLevel + 1> levels;
+
+	// Best-first descent through nodes that satisfy qualifies, ordered by
+	// distance to their bounds. The first node with no qualifying child is
+	// the answer; bounds only shrink going down, so nothing nearer is missed.
+	template <typename Fn>
+	ResourceHit Search(TILE_TYPE type, glm::ivec2 fromTile, Fn qualifies) const {
+		struct Candidate {
+			int64_t distance;
+			int level;
+			glm::ivec2 coord;
+			bool operator>(const Candidate &other) const { return distance > other.distance; }
+		};
+		std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> open;
+
+		for (const auto &[coord, totals] : levels[TopLevel]) {
+			if (qualifies(TopLevel, totals[type])) {
+				open.push({totals[type].DistanceSquared(fromTile), TopLevel, coord});
+			}
+		}
+
+		while (!open.empty()) {
+			Candidate candidate = open.top();
+			open.pop();
+
+			bool refined = false;
+			if (candidate.level > 0) {
+				int childLevel = candidate.level - 1;
+				ForEachChild(candidate.coord, [&](const glm::ivec2 &child) {
+					const ResourceTotals *totals = levels[childLevel].Find(child);
+					if (!totals || !qualifies(childLevel, (*totals)[type])) return;
+					open.push({(*totals)[type].DistanceSquared(fromTile), childLevel, child});
+					refined = true;
+				});
+			}
+			if (refined) continue;
+
+			ResourceHit hit;
+			hit.found = true;
+			hit.level = candidate.level;
+			hit.chunkMin = candidate.coord * (1 << candidate.level);
+			hit.chunkMax = hit.chunkMin + glm::ivec2(1 << candidate.level);
+			hit.total = (*levels[candidate.level].Find(candidate.coord))[type];
+			return hit;
+		}
+		return ResourceHit();
+	}
+
+	template <typename Fn>
+	static void ForEachChild(const glm::ivec2 &coord, Fn fn) {
+		for (int dy = 0; dy < 2; dy++) {
+			for (int dx = 0; dx < 2; dx++) {
+				fn(glm::ivec2(coord.x * 2 + dx, coord.y * 2 + dy));
+			}
+		}
+	}
+
+	// Rebuild every node above a chunk from its children
+	void UpdateAncestors(const glm::ivec2 &chunkCoord) {
+		for (int level = 1; level <= TopLevel; level++) {
+			glm::ivec2 coord(chunkCoord.x >> level, chunkCoord.y >> level);
+
+			ResourceTotals merged;
+			bool any = false;
+			ForEachChild(coord, [&](const glm::ivec2 &child) {
+				const ResourceTotals *totals = levels[level - 1].Find(child);
+				if (!totals) return;
+				for (int type = 0; type < TILE_TYPE_COUNT; type++) {
+					const ResourceTotal &total = (*totals)[type];
+					merged[type].Merge(total);
+					merged[type].chunkPeak = std::max(merged[type].chunkPeak, level == 1 ? total.tiles : total.chunkPeak);
+				}
+				any = true;
+			});
+
+			if (any) {
+				levels[level][coord] = merged;
+			} else {
+				levels[level].erase(coord);
+			}
+		}
+	}
+
+	void Accumulate(TILE_TYPE type, int level, glm::ivec2 coord, glm::ivec2 chunkMin, glm::ivec2 chunkMax,
+					ResourceTotal &total) const {
+		const ResourceTotals *totals = levels[level].Find(coord);
+		if (!totals || (*totals)[type].tiles == 0) return;
+
+		glm::ivec2 nodeMin = coord * (1 << level);
+		glm::ivec2 nodeMax = nodeMin + glm::ivec2(1 << level);
+		if (nodeMax.x <= chunkMin.x || nodeMin.x >= chunkMax.x || nodeMax.y <= chunkMin.y || nodeMin.y >= chunkMax.y) {
+			return;
+		}
+		if (nodeMin.x >= chunkMin.x && nodeMax.x <= chunkMax.x && nodeMin.y >= chunkMin.y && nodeMax.y <= chunkMax.y) {
+			total.Merge((*totals)[type]);
+			return;
+		}
+
+		ForEachChild(coord, [&](const glm::ivec2 &child) {
+			Accumulate(type, level - 1, child, chunkMin, chunkMax, total);
+		});
+	}
+};
+
+#endif
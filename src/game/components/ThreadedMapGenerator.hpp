@@ -2,291 +2,216 @@
 #define THREADED_MAP_GENERATOR_H
 
 #include <thread>
-#include <mutex>
-#include <condition_variable>
-#include <queue>
 #include <atomic>
-#include <future>
-#include <unordered_map>
-#include <functional>
+#include <iterator>
 #include <memory>
 #include <chrono>
-#include <unordered_set>
+#include <deque>
+#include "Building.hpp"
 #include "Chunk.hpp"
+#include "ChunkResidency.hpp"
+#include "ChunkStreamer.hpp"
+#include "ChunkTelemetry.hpp"
+#include "ResourceIndex.hpp"
+#include "World.hpp"
 #include "MapGenerator.hpp"
 #include "../utils/GeneratorSettings.hpp"
 #include "../entities/ChunkEntity.hpp"
 #include "../../engine/ecs/components/Camera.hpp"
-
-struct ChunkGenerationRequest {
-	glm::ivec2 chunkCoord;
-	GeneratorSettings settings;
-	int priority; // Higher = more important
-	std::chrono::steady_clock::time_point requestTime;
-
-	bool operator<(const ChunkGenerationRequest &other) const {
-		// Higher priority first, then by request time
-		if (priority != other.priority) {
-			return priority < other.priority;
-		}
-		return requestTime > other.requestTime;
-	}
+#include "../../engine/async/Scheduler.hpp"
+#include "../../engine/async/Task.hpp"
+#include "../../engine/ecs/SystemScheduler.hpp"
+#include "../../engine/utils/ChunkMap.hpp"
+
+// One in-flight chunk request. Shared between the generator, which can
+// cancel it, and the coroutine generating it.
+struct ChunkJob {
+	std::atomic<bool> cancelled{false};
+	ChunkRequestTiming timing;
 };
 
 struct ChunkGenerationResult {
 	glm::ivec2 chunkCoord;
-	std::vector<TileEntity *> tiles;
-	bool success;
+	ChunkTiles tiles;
+	ChunkSummary summary;
+	bool success = false;
+	bool cancelled = false;
 	std::string errorMessage;
+	ChunkRequestTiming timing;
 };
 
+// Generates chunks as coroutines on the shared thread pool. Only the job
+// table lives here; it is touched from the main thread only.
 class ThreadedMapGenerator {
 private:
-	// Thread pool
-	std::vector<std::thread> workers;
-	std::atomic<bool> shouldStop{false};
-	std::atomic<bool> isInitialized{false};
-
-	// Work queue - using shared_ptr to avoid copy issues
-	std::priority_queue<ChunkGenerationRequest> workQueue;
-	mutable std::mutex queueMutex;
-	std::condition_variable queueCondition;
-
-	// Results
-	std::queue<ChunkGenerationResult> completedChunks;
-	mutable std::mutex resultsMutex;
-
 	// Currently generating chunks (to avoid duplicates)
-	std::unordered_set<glm::ivec2> generatingChunks;
-	mutable std::mutex generatingMutex;
-
-	// Thread count
-	size_t threadCount;
+	ChunkMap<std::shared_ptr<ChunkJob>> generatingChunks;
 
 	// Statistics
-	std::atomic<size_t> chunksGenerated{0};
-	std::atomic<size_t> chunksQueued{0};
-
-	// Thread-safe initialization
-	static std::once_flag initFlag;
-	static void InitializeMapGenerator() {
-		// This ensures thread-safe initialization of static members
-		// Call this once before any threaded operations
-	}
+	size_t chunksGenerated = 0;
+	size_t chunksQueued = 0;
+	ChunkTelemetry telemetry;
 
 public:
-	ThreadedMapGenerator(size_t numThreads = std::thread::hardware_concurrency())
-		: threadCount(numThreads) {
-		
-		// Ensure thread-safe initialization
-		std::call_once(initFlag, InitializeMapGenerator);
-		
-		// Create worker threads
-		for (size_t i = 0; i < threadCount; ++i) {
-			workers.emplace_back([this]() { WorkerThread(); });
+	// Register a chunk request. Returns nullptr if the chunk is already being
+	// generated.
+	std::shared_ptr<ChunkJob> RequestChunk(const glm::ivec2 &chunkCoord) {
+		if (generatingChunks.contains(chunkCoord)) {
+			return nullptr; // Already generating
 		}
-		
-		isInitialized = true;
-	}
 
-	~ThreadedMapGenerator() {
-		Stop();
+		auto job = std::make_shared<ChunkJob>();
+		job->timing.chunkCoord = chunkCoord;
+		job->timing.requested = TelemetryClock::now();
+		generatingChunks[chunkCoord] = job;
+		chunksQueued++;
+		return job;
 	}
 
-	void Stop() {
-		if (!isInitialized) return;
-		
-		shouldStop = true;
-		queueCondition.notify_all();
-
-		for (auto &worker : workers) {
-			if (worker.joinable()) {
-				worker.join();
-			}
+	// Called once the job's result is back on the main thread
+	void FinishJob(const glm::ivec2 &chunkCoord, const std::shared_ptr<ChunkJob> &job, bool generated) {
+		auto it = generatingChunks.find(chunkCoord);
+		if (it != generatingChunks.end() && it->second == job) {
+			generatingChunks.erase(it);
 		}
-		
-		// Clean up any remaining results
-		{
-			std::lock_guard<std::mutex> lock(resultsMutex);
-			while (!completedChunks.empty()) {
-				auto& result = completedChunks.front();
-				// Clean up tiles
-				for (auto* tile : result.tiles) {
-					delete tile;
-				}
-				completedChunks.pop();
-			}
+		if (generated) {
+			chunksGenerated++;
 		}
 	}
 
-	// Request chunk generation with priority
-	void RequestChunk(const glm::ivec2 &chunkCoord, const GeneratorSettings &settings, int priority = 0) {
-		if (shouldStop || !isInitialized) return;
-		
-		{
-			std::lock_guard<std::mutex> lock(generatingMutex);
-			if (generatingChunks.find(chunkCoord) != generatingChunks.end()) {
-				return; // Already generating
-			}
-			generatingChunks.insert(chunkCoord);
-		}
-
-		ChunkGenerationRequest request;
-		request.chunkCoord = chunkCoord;
-		request.settings = settings;
-		request.priority = priority;
-		request.requestTime = std::chrono::steady_clock::now();
+	// Cancel chunk generation request
+	void CancelChunk(const glm::ivec2 &chunkCoord) {
+		auto it = generatingChunks.find(chunkCoord);
+		if (it == generatingChunks.end()) return;
+		it->second->cancelled = true;
+		generatingChunks.erase(it);
+	}
 
-		{
-			std::lock_guard<std::mutex> lock(queueMutex);
-			workQueue.push(request);
-			chunksQueued++;
+	// Cancel all pending requests
+	void ClearQueue() {
+		for (auto &[coord, job] : generatingChunks) {
+			job->cancelled = true;
 		}
-
-		queueCondition.notify_one();
+		generatingChunks.clear();
+		chunksQueued = 0;
 	}
 
-	// Get completed chunks (call from main thread)
-	std::vector<ChunkGenerationResult> GetCompletedChunks() {
-		std::vector<ChunkGenerationResult> results;
-		
-		if (!isInitialized) return results;
-
-		std::lock_guard<std::mutex> lock(resultsMutex);
-		while (!completedChunks.empty()) {
-			results.push_back(std::move(completedChunks.front()));
-			completedChunks.pop();
+	// Generate a chunk on the pool. With bands > 1 the chunk's rows are split
+	// into that many tasks so idle workers can share one chunk; whichever
+	// finishes last places ores and builds the tiles. Completes on a worker
+	// thread.
+	static Task<ChunkGenerationResult> Generate(glm::ivec2 chunkCoord, GeneratorSettings settings, int priority, int bands,
+												std::shared_ptr<ChunkJob> job) {
+		ChunkGenerationResult result;
+		result.chunkCoord = chunkCoord;
+		result.timing = job->timing;
+
+		co_await Async::Pool().Schedule(priority);
+
+		// Check if chunk is still needed
+		if (job->cancelled) {
+			result.cancelled = true;
+			co_return result;
 		}
 
-		return results;
-	}
+		result.timing.worker = Async::ThreadPool::CurrentWorker();
+		result.timing.dequeued = TelemetryClock::now();
 
-	// Cancel chunk generation request
-	void CancelChunk(const glm::ivec2 &chunkCoord) {
-		std::lock_guard<std::mutex> lock(generatingMutex);
-		generatingChunks.erase(chunkCoord);
-	}
+		try {
+			bands = std::clamp(bands, 1, CHUNK_SIZE);
+			if (bands == 1) {
+				result.tiles = MapGenerator::Generate(chunkCoord.x, chunkCoord.y, settings, &result.summary);
+			} else {
+				std::vector<Task<std::vector<std::string>>> bandTasks;
+				for (int band = 0; band < bands; band++) {
+					bandTasks.push_back(GenerateBand(chunkCoord, band * CHUNK_SIZE / bands,
+													 (band + 1) * CHUNK_SIZE / bands, settings, priority));
+				}
+				std::vector<std::vector<std::string>> bandRows = co_await Async::WhenAll(std::move(bandTasks));
 
-	// Clear all pending requests
-	void ClearQueue() {
-		{
-			std::lock_guard<std::mutex> lock(queueMutex);
-			std::priority_queue<ChunkGenerationRequest> empty;
-			workQueue.swap(empty);
-			chunksQueued = 0;
+				std::vector<std::string> terrain;
+				terrain.reserve(CHUNK_SIZE * CHUNK_SIZE);
+				for (auto &rows : bandRows) {
+					std::move(rows.begin(), rows.end(), std::back_inserter(terrain));
+				}
+				result.tiles = MapGenerator::Finalize(chunkCoord.x, chunkCoord.y, terrain, settings, &result.summary);
+			}
+			result.success = true;
+		} catch (const std::exception &e) {
+			result.errorMessage = e.what();
+		} catch (...) {
+			result.errorMessage = "Unknown error during chunk generation";
 		}
 
-		{
-			std::lock_guard<std::mutex> genLock(generatingMutex);
-			generatingChunks.clear();
-		}
+		result.timing.generated = TelemetryClock::now();
+		co_return result;
 	}
 
 	// Statistics
-	size_t GetQueueSize() const {
-		if (!isInitialized) return 0;
-		std::lock_guard<std::mutex> lock(queueMutex);
-		return workQueue.size();
-	}
-
+	size_t GetQueueSize() const { return Async::Pool().GetQueueSize(); }
+	size_t GetThreadCount() const { return Async::Pool().GetThreadCount(); }
 	size_t GetChunksGenerated() const { return chunksGenerated; }
 	size_t GetChunksQueued() const { return chunksQueued; }
+	ChunkTelemetry &GetTelemetry() { return telemetry; }
 
 	bool IsGenerating(const glm::ivec2 &chunkCoord) const {
-		if (!isInitialized) return false;
-		std::lock_guard<std::mutex> lock(generatingMutex);
-		return generatingChunks.find(chunkCoord) != generatingChunks.end();
+		return generatingChunks.contains(chunkCoord);
 	}
 
 private:
-	void WorkerThread() {
-		while (!shouldStop) {
-			ChunkGenerationRequest request;
-			bool hasWork = false;
-
-			// Get work from queue
-			{
-				std::unique_lock<std::mutex> lock(queueMutex);
-				queueCondition.wait(lock, [this] { return !workQueue.empty() || shouldStop; });
-
-				if (shouldStop) break;
-
-				if (!workQueue.empty()) {
-					request = workQueue.top();
-					workQueue.pop();
-					hasWork = true;
-				}
-			}
-
-			if (!hasWork) continue;
-
-			// Check if chunk is still needed
-			bool shouldGenerate = false;
-			{
-				std::lock_guard<std::mutex> lock(generatingMutex);
-				shouldGenerate = generatingChunks.find(request.chunkCoord) != generatingChunks.end();
-			}
-
-			if (!shouldGenerate) continue;
-
-			// Generate the chunk
-			ChunkGenerationResult result;
-			result.chunkCoord = request.chunkCoord;
-			result.success = true;
-
-			try {
-				// CRITICAL: Make sure MapGenerator is thread-safe
-				result.tiles = MapGenerator::Generate(
-					request.chunkCoord.x,
-					request.chunkCoord.y,
-					request.settings);
-				chunksGenerated++;
-			} catch (const std::exception &e) {
-				result.success = false;
-				result.errorMessage = e.what();
-
-				// Clean up any partial tiles
-				for (auto *tile : result.tiles) {
-					delete tile;
-				}
-				result.tiles.clear();
-			} catch (...) {
-				result.success = false;
-				result.errorMessage = "Unknown error during chunk generation";
-				
-				// Clean up any partial tiles
-				for (auto *tile : result.tiles) {
-					delete tile;
-				}
-				result.tiles.clear();
-			}
-
-			// Remove from generating set
-			{
-				std::lock_guard<std::mutex> lock(generatingMutex);
-				generatingChunks.erase(request.chunkCoord);
-			}
-
-			// Add to results
-			{
-				std::lock_guard<std::mutex> lock(resultsMutex);
-				completedChunks.push(std::move(result));
-			}
-		}
+	// Terrain for rows [rowBegin, rowEnd) of one chunk
+	static Task<std::vector<std::string>> GenerateBand(glm::ivec2 chunkCoord, int rowBegin, int rowEnd,
+													   GeneratorSettings settings, int priority) {
+		co_await Async::Pool().Schedule(priority);
+		co_return MapGenerator::GenerateTerrainRows(chunkCoord.x, chunkCoord.y, rowBegin, rowEnd, settings);
 	}
 };
 
-// Static member definition
-std::once_flag ThreadedMapGenerator::initFlag;
-
 // Updated Map component to use threaded generation
 struct ThreadedMap : IComponent {
-	std::unordered_map<glm::ivec2, Entity *> chunks;
+	ChunkMap<Entity *> chunks;
 	std::unique_ptr<ThreadedMapGenerator> generator;
 	GeneratorSettings settings;
+	World world;
+	// Resource summaries of every generated chunk, resident or cached
+	ResourceIndex resources;
+	ChunkResidencyManager residency;
+	ChunkStreamer streamer;
+	uint64_t frame = 0;
 
 	// Chunks that are being generated
-	std::unordered_set<glm::ivec2> pendingChunks;
+	ChunkSet pendingChunks;
+
+	// Cached chunks waiting to be decompressed, drained a few per frame
+	std::deque<glm::ivec2> promotionQueue;
+	ChunkSet promotingChunks;
+	bool evictionCheckNeeded = false;
+
+	// Change cursor of the render sync; chunk changes at or after it are
+	// still to upload
+	uint64_t renderSyncTick = 0;
+	// Chunks edited since the last sync, collected and drained within one
+	// run of the render sync systems
+	std::vector<Chunk *> syncChunks;
+
+	// Let a compute pass choose the chunks to draw rather than the CPU
+	bool gpuCulling = true;
+
+	// Resources panel query
+	int resourceQueryOre = 0;
+	int resourceQueryMinTiles = 500;
+
+	// Chunk coroutines outlive the map; they check these once back on the
+	// main thread. mapVersion is bumped whenever the map is regenerated so
+	// stale results are dropped.
+	std::shared_ptr<bool> alive = std::make_shared<bool>(true);
+	uint64_t mapVersion = 0;
+
+	// Until the first view is complete, chunks are split into row bands
+	// across all workers so the first playable frame arrives sooner
+	bool startupBurst = true;
+	TelemetryClock::time_point startTime = TelemetryClock::now();
+	double firstCompleteFrameMs = 0.0;
 	
 	// Safety flags
 	std::atomic<bool> isUpdating{false};
@@ -302,12 +227,14 @@ struct ThreadedMap : IComponent {
 			std::this_thread::sleep_for(std::chrono::milliseconds(1));
 		}
 		
-		generator->Stop();
+		*alive = false;
+		generator->ClearQueue();
+		world.Clear();
 		
 		// Clean up chunks
 		for (auto &[coord, entity] : chunks) {
 			if (entity) {
-				delete entity;
+				entity->Destroy();
 			}
 		}
 		chunks.clear();
@@ -317,10 +244,52 @@ struct ThreadedMap : IComponent {
 		// Initialize generator if needed
 	}
 
+	// Register the systems that upload tiles edited through the world. Chunks
+	// are marked changed in the registry when World edits their tiles, so
+	// only chunks edited since the last sync are visited. Preparing each
+	// chunk's upload is the bulk of the work and runs on the pool; the main
+	// thread only hands the result to GL. Systems run after the map's update,
+	// so edits are drawn from the next frame.
+	void AddSystems(SystemScheduler &systems) {
+		std::shared_ptr<bool> mapAlive = alive;
+
+		// Consuming changes starts a new registry tick, which every pool reads
+		systems.Add("Chunk Changes", SystemAccess().Exclusive().MainThread(), [this, mapAlive](Registry &registry) {
+			if (!*mapAlive) return;
+			registry.ConsumeChanges<Chunk *>(renderSyncTick, [&](EntityId, Chunk *chunk) {
+				// Chunks of another map, or already replaced in this one
+				Entity *const *entity = chunks.Find(chunk->transform->position);
+				if (!entity || *entity != chunk->entity || chunk->entity->IsDestroyed()) return;
+				syncChunks.push_back(chunk);
+			});
+		});
+
+		// Preparing clears each chunk's changed tiles, so it writes the chunks
+		systems.Add("Chunk Sync", SystemAccess().Write<Chunk *, ChunkRenderer *>(),
+					[this, mapAlive](Registry &) {
+						if (!*mapAlive) return;
+						Async::ParallelFor(syncChunks.size(),
+										   [&](size_t i) { syncChunks[i]->renderer->PrepareSync(*syncChunks[i]); });
+					});
+
+		systems.Add("Chunk Upload", SystemAccess().Read<Chunk *>().Write<ChunkRenderer *>().MainThread(),
+					[this, mapAlive](Registry &) {
+						if (!*mapAlive) return;
+						for (Chunk *chunk : syncChunks) {
+							glm::ivec2 chunkCoord = chunk->transform->position;
+							chunk->renderer->UploadSync();
+							resources.Set(chunkCoord, chunk->summary);
+							residency.OnResident(chunkCoord, chunk->ResidentBytes(), frame);
+						}
+						syncChunks.clear();
+					});
+	}
+
 	void Update() override {
 		if (isDestroying) return;
 		
 		isUpdating = true;
+		frame++;
 		
 		// Handle ImGui settings - make sure this is called from main thread
 		if (ImGui::GetCurrentContext() != nullptr) {
@@ -331,11 +300,37 @@ struct ThreadedMap : IComponent {
 			ImGui::Text("Queue Size: %zu", generator->GetQueueSize());
 			ImGui::Text("Generated: %zu", generator->GetChunksGenerated());
 			ImGui::Text("Pending: %zu", pendingChunks.size());
+			ImGui::Text("Promoting: %zu", promotingChunks.size());
 			ImGui::Text("Active Chunks: %zu", chunks.size());
+			ImGui::Text("View Changes: %zu", streamer.GetChangeCount());
+			// The LOD fading in over the tiles takes a second draw
+			float lodBlend = ChunkRenderer::Batch().LodBlend();
+			int drawCalls = (lodBlend < 1.0f) + (lodBlend > 0.0f);
+			ImGui::Text(gpuCulling ? "Chunks Tested on GPU: %zu (%d draw calls)" : "Drawn Chunks: %zu (%d draw calls)",
+						ChunkRenderer::Batch().GetLastDrawCount(), drawCalls);
+			ImGui::Text("Chunk LOD: %.0f%%", lodBlend * 100.0f);
+			ImGui::Checkbox("Tilemap Terrain", &ChunkRenderer::Batch().tilemap);
+			ImGui::Checkbox("GPU Culling", &gpuCulling);
+			if (startupBurst) {
+				ImGui::Text("Startup Burst: active");
+			} else {
+				ImGui::Text("First Complete Frame: %.1f ms", firstCompleteFrameMs);
+			}
+
+			if (ImGui::CollapsingHeader("Telemetry")) {
+				generator->GetTelemetry().DrawImGui();
+			}
+
+			residency.DrawImGui();
+
+			if (ImGui::CollapsingHeader("Resources")) {
+				DrawResourceQuery();
+			}
 
 			if (ImGui::Button("Clear Queue")) {
 				generator->ClearQueue();
 				pendingChunks.clear();
+				streamer.Reset();
 			}
 
 			ImGui::Text("Presets");
@@ -349,178 +344,322 @@ struct ThreadedMap : IComponent {
 		if (settings.regenerateMap) {
 			generator->ClearQueue();
 
-			// Clean up existing chunks
+			// Clean up existing chunks and the buildings on them
+			world.Clear();
+			Buildings::Clear(Simplex::simulation);
 			for (auto &[coord, entity] : chunks) {
 				if (entity) {
-					delete entity;
+					entity->Destroy();
 				}
 			}
 			chunks.clear();
 			pendingChunks.clear();
+			promotionQueue.clear();
+			promotingChunks.clear();
+			residency.Clear();
+			resources.Clear();
+			streamer.Reset();
+			mapVersion++;
+
+			// A fresh map is another startup as far as the player is concerned
+			startupBurst = true;
+			startTime = TelemetryClock::now();
 
 			settings.regenerateMap = false;
 		}
 
-		// Process completed chunks
-		ProcessCompletedChunks();
+		// Request chunks entering the view, release chunks leaving it
+		StreamChunks();
 
-		// Generate new chunks
-		GenerateChunks();
+		// Bring back previously evicted chunks
+		PromoteCachedChunks();
 
-		// Cull distant chunks
-		CullChunks();
+		// Evict distant chunks once over the memory budget
+		EvictChunks();
 
-		// Update existing chunks
-		for (auto &[coord, chunk] : chunks) {
-			if (chunk && !isDestroying) {
-				chunk->UpdateComponents();
-			}
+		// Buildings update on the simulation; only drawing is left here
+		if (!isDestroying) {
+			DrawChunks();
+		}
+
+		if (startupBurst) {
+			CheckStartupComplete();
 		}
 		
 		isUpdating = false;
 	}
 
 private:
-	void ProcessCompletedChunks() {
-		auto completedChunks = generator->GetCompletedChunks();
-
-		for (auto &result : completedChunks) {
-			if (isDestroying) {
-				// Clean up tiles if we're destroying
-				for (auto* tile : result.tiles) {
-					delete tile;
-				}
-				continue;
+	// Generate a chunk on the pool, then integrate and upload it on the main
+	// thread at the start of the next frame
+	Task<void> LoadChunk(glm::ivec2 chunkCoord, int priority, int bands, std::shared_ptr<ChunkJob> job) {
+		std::shared_ptr<bool> mapAlive = alive;
+		uint64_t version = mapVersion;
+
+		ChunkGenerationResult result = co_await ThreadedMapGenerator::Generate(chunkCoord, settings, priority, bands, job);
+		co_await Async::MainThread().NextFrame();
+		result.timing.collected = TelemetryClock::now();
+
+		if (!*mapAlive || version != mapVersion) {
+			co_return;
+		}
+
+		generator->FinishJob(chunkCoord, job, result.success);
+		if (result.cancelled) {
+			generator->GetTelemetry().RecordCancelled();
+			co_return;
+		}
+
+		bool wanted = pendingChunks.erase(chunkCoord) > 0 || streamer.ShouldLoad(chunkCoord);
+		bool resident = chunks.find(chunkCoord) != chunks.end();
+
+		if (result.success && (!wanted || resident)) {
+			// Cancelled after the worker had already started; keep the work
+			// in the cold cache rather than throwing it away
+			generator->GetTelemetry().RecordWasted();
+			if (!resident) {
+				residency.Store(chunkCoord, result.tiles);
+				resources.Set(chunkCoord, result.summary);
 			}
-			
-			pendingChunks.erase(result.chunkCoord);
-
-			if (result.success) {
-				// Create chunk entity
-				Entity *chunkEntity = new ChunkEntity(result.chunkCoord);
-				Chunk *chunkComponent = chunkEntity->GetComponent<Chunk>();
-
-				if (chunkComponent) {
-					// Set tiles directly instead of generating
-					chunkComponent->tiles = std::move(result.tiles);
-					chunkComponent->Generated = true;
-
-					chunks[result.chunkCoord] = chunkEntity;
-                    chunkEntity->GetComponent<ChunkRenderer>()->AddChunkToSSBO(*chunkComponent);
-				} else {
-					// Clean up if chunk creation failed
-					delete chunkEntity;
-					for (auto* tile : result.tiles) {
-						delete tile;
-					}
-				}
-			} else {
-				// Handle generation error
-				printf("Chunk generation failed for (%d, %d): %s\n",
-					   result.chunkCoord.x, result.chunkCoord.y,
-					   result.errorMessage.c_str());
-				
-				// Clean up tiles
-				for (auto* tile : result.tiles) {
-					delete tile;
-				}
+		} else if (result.success) {
+			AddChunk(chunkCoord, result.tiles, &result.summary);
+			result.timing.integrated = TelemetryClock::now();
+			generator->GetTelemetry().RecordCompleted(result.timing);
+		} else {
+			// Handle generation error
+			printf("Chunk generation failed for (%d, %d): %s\n",
+				   chunkCoord.x, chunkCoord.y, result.errorMessage.c_str());
+		}
+	}
+
+	// Read and decode a cached chunk on the pool, then upload it on the main
+	// thread. Falls back to regenerating if the cached copy is unreadable.
+	Task<void> PromoteChunk(glm::ivec2 chunkCoord, ChunkResidencyManager::StoredChunk stored) {
+		std::shared_ptr<bool> mapAlive = alive;
+		uint64_t version = mapVersion;
+
+		co_await Async::Pool().Schedule(100);
+		ChunkTiles tiles;
+		bool decoded = ChunkResidencyManager::Load(chunkCoord, std::move(stored), tiles);
+		co_await Async::MainThread().NextFrame();
+
+		if (!*mapAlive || version != mapVersion) {
+			co_return;
+		}
+		promotingChunks.erase(chunkCoord);
+
+		bool wanted = streamer.ShouldKeep(chunkCoord) && chunks.find(chunkCoord) == chunks.end();
+		if (!decoded) {
+			if (wanted && !pendingChunks.contains(chunkCoord)) {
+				RequestChunk(chunkCoord, 100);
 			}
+		} else if (wanted) {
+			AddChunk(chunkCoord, tiles);
+		} else {
+			// Left the view while decoding; put it back
+			residency.Store(chunkCoord, tiles);
 		}
 	}
 
-	void GenerateChunks() {
+	// Create the chunk entity for a set of tiles and upload it. Without a
+	// summary from the generator, the indexed one is reused so ore amounts
+	// survive eviction.
+	void AddChunk(const glm::ivec2 &chunkCoord, const ChunkTiles &tiles, const ChunkSummary *summary = nullptr) {
+		auto existing = chunks.find(chunkCoord);
+		if (existing != chunks.end()) {
+			residency.OnRemoved(chunkCoord);
+			world.RemoveChunk(chunkCoord);
+			existing->second->Destroy();
+			chunks.erase(existing);
+		}
+
+		Entity *chunkEntity = new ChunkEntity(chunkCoord);
+		Chunk *chunkComponent = chunkEntity->GetComponent<Chunk>();
+
+		// Set tiles directly instead of generating
+		chunkComponent->tiles = tiles;
+		chunkComponent->Generated = true;
+		if (summary) {
+			chunkComponent->summary = *summary;
+		} else if (!resources.Get(chunkCoord, chunkComponent->summary)) {
+			chunkComponent->summary = ChunkSummary::FromTiles(chunkCoord, tiles);
+		}
+		resources.Set(chunkCoord, chunkComponent->summary);
+
+		chunks[chunkCoord] = chunkEntity;
+		world.AddChunk(chunkCoord, chunkComponent);
+		chunkEntity->GetComponent<ChunkRenderer>()->AddChunkToSSBO(*chunkComponent);
+		residency.OnResident(chunkCoord, chunkComponent->ResidentBytes(), frame);
+		evictionCheckNeeded = true;
+	}
+
+	// Apply the streamer's delta. While the camera stays within the same
+	// chunk-space view this does no work beyond computing the view rect.
+	void StreamChunks() {
 		if (isDestroying) return;
-		
-		RectBounds<int> chunkCoords = CalculateChunksInView();
 
-		// Expand bounds slightly for buffering
-		int buffer = 2;
-		chunkCoords.top += buffer;
-		chunkCoords.bottom -= buffer;
-		chunkCoords.left -= buffer;
-		chunkCoords.right += buffer;
+		streamer.keepMargin = residency.settings.keepMargin;
+		StreamingDelta delta = streamer.Update(CalculateChunksInView(), GetCameraChunkCoord());
+		if (delta.Empty()) return;
 
-		// Calculate priorities based on distance from camera
-		glm::ivec2 cameraChunk = GetCameraChunkCoord();
+		for (const auto &chunkCoord : delta.removed) {
+			if (pendingChunks.erase(chunkCoord)) {
+				generator->CancelChunk(chunkCoord);
+			}
+			// Age for eviction counts from when the chunk stopped being wanted
+			residency.Touch(chunkCoord, frame);
+		}
 
-		std::vector<std::pair<glm::ivec2, int>> chunksToGenerate;
+		for (const auto &[chunkCoord, priority] : delta.added) {
+			// Skip if already exists or is being generated
+			if (chunks.find(chunkCoord) != chunks.end() ||
+				pendingChunks.contains(chunkCoord) ||
+				promotingChunks.contains(chunkCoord)) {
+				continue;
+			}
 
-		for (int y = chunkCoords.bottom; y < chunkCoords.top; y++) {
-			for (int x = chunkCoords.left; x < chunkCoords.right; x++) {
-				glm::ivec2 chunkCoord(x, y);
+			// Bring back chunks we have seen before instead of regenerating them
+			if (residency.IsStored(chunkCoord)) {
+				promotionQueue.push_back(chunkCoord);
+				continue;
+			}
 
-				// Skip if already exists or is being generated
-				if (chunks.find(chunkCoord) != chunks.end() ||
-					pendingChunks.find(chunkCoord) != pendingChunks.end()) {
-					continue;
-				}
+			RequestChunk(chunkCoord, priority);
+		}
 
-				// Calculate priority based on distance from camera
-				int distance = abs(chunkCoord.x - cameraChunk.x) + abs(chunkCoord.y - cameraChunk.y);
-				int priority = 100 - distance; // Higher priority for closer chunks
+		evictionCheckNeeded = true;
+	}
+
+	void RequestChunk(const glm::ivec2 &chunkCoord, int priority) {
+		std::shared_ptr<ChunkJob> job = generator->RequestChunk(chunkCoord);
+		if (!job) return;
+
+		int bands = startupBurst ? static_cast<int>(generator->GetThreadCount()) : 1;
+		pendingChunks.insert(chunkCoord);
+		Async::Spawn(LoadChunk(chunkCoord, priority, bands, job));
+	}
 
-				chunksToGenerate.push_back({chunkCoord, priority});
+	// Leave startup burst mode once every chunk in view is resident
+	void CheckStartupComplete() {
+		if (!Simplex::view.GetCamera()) return;
+
+		RectBounds<int> view = CalculateChunksInView();
+		for (int y = view.bottom; y <= view.top; y++) {
+			for (int x = view.left; x <= view.right; x++) {
+				if (chunks.find(glm::ivec2(x, y)) == chunks.end()) {
+					return;
+				}
 			}
 		}
 
-		// Sort by priority and request generation
-		std::sort(chunksToGenerate.begin(), chunksToGenerate.end(),
-				  [](const auto &a, const auto &b) { return a.second > b.second; });
+		startupBurst = false;
+		firstCompleteFrameMs = ChunkRequestTiming::Ms(startTime, TelemetryClock::now());
+		printf("First complete frame after %.1f ms (%zu chunks resident)\n", firstCompleteFrameMs, chunks.size());
+	}
+
+	void PromoteCachedChunks() {
+		int promotions = 0;
+		while (!promotionQueue.empty() && promotions < residency.settings.promotionsPerFrame) {
+			glm::ivec2 chunkCoord = promotionQueue.front();
+			promotionQueue.pop_front();
 
-		for (const auto &[coord, priority] : chunksToGenerate) {
-			generator->RequestChunk(coord, settings, priority);
-			pendingChunks.insert(coord);
+			if (!streamer.ShouldKeep(chunkCoord) || chunks.find(chunkCoord) != chunks.end() ||
+				promotingChunks.contains(chunkCoord)) {
+				continue;
+			}
+
+			ChunkResidencyManager::StoredChunk stored;
+			if (residency.Take(chunkCoord, stored)) {
+				promotingChunks.insert(chunkCoord);
+				Async::Spawn(PromoteChunk(chunkCoord, std::move(stored)));
+				promotions++;
+			} else if (!pendingChunks.contains(chunkCoord)) {
+				RequestChunk(chunkCoord, 100);
+			}
 		}
 	}
 
-	void CullChunks() {
-		if (isDestroying) return;
-		
-		RectBounds<int> chunkCoords = CalculateChunksInView();
-		int cullBuffer = 5; // Larger buffer for culling
+	void DrawResourceQuery() {
+		static const TILE_TYPE ores[] = {TILE_IRON_ORE, TILE_COPPER_ORE, TILE_COAL_ORE, TILE_GOLD_ORE};
+		static const char *oreNames[] = {"Iron", "Copper", "Coal", "Gold"};
+		ImGui::Combo("Ore", &resourceQueryOre, oreNames, IM_ARRAYSIZE(oreNames));
+		IMGUI_FIELD_INT("Min Tiles", resourceQueryMinTiles);
+		resourceQueryMinTiles = std::max(resourceQueryMinTiles, 1);
+
+		TILE_TYPE ore = ores[resourceQueryOre];
+		glm::ivec2 cameraTile = GetCameraChunkCoord() * CHUNK_SIZE + glm::ivec2(CHUNK_SIZE / 2);
+		ImGui::Text("Indexed Chunks: %zu", resources.GetChunkCount());
+
+		ResourceHit hit = resources.FindNearest(ore, cameraTile, static_cast<uint32_t>(resourceQueryMinTiles));
+		if (hit.found) {
+			ImGui::Text("Nearest: chunks (%d, %d) to (%d, %d)", hit.chunkMin.x, hit.chunkMin.y, hit.chunkMax.x - 1, hit.chunkMax.y - 1);
+			ImGui::Text("  %u tiles, %llu ore", hit.total.tiles, static_cast<unsigned long long>(hit.total.amount));
+		} else {
+			ImGui::Text("Nearest: none found");
+		}
 
-		for (auto it = chunks.begin(); it != chunks.end();) {
-			glm::ivec2 chunkCoord = it->first;
+		RectBounds<int> view = CalculateChunksInView();
+		ResourceTotal inView = resources.RegionTotal(ore, glm::ivec2(view.left, view.bottom), glm::ivec2(view.right + 1, view.top + 1));
+		ImGui::Text("In View: %u tiles, %llu ore", inView.tiles, static_cast<unsigned long long>(inView.amount));
+	}
 
-			bool shouldCull = (chunkCoord.x < chunkCoords.left - cullBuffer ||
-							   chunkCoord.x >= chunkCoords.right + cullBuffer ||
-							   chunkCoord.y < chunkCoords.bottom - cullBuffer ||
-							   chunkCoord.y >= chunkCoords.top + cullBuffer) &&
-							  chunks.size() > 135;
+	// Only chunks in view are drawn, in one call; the rest of the resident
+	// set is margin for streaming. By default the GPU picks them, so the
+	// frame's CPU cost doesn't depend on how many chunks are resident.
+	void DrawChunks() {
+		if (gpuCulling) {
+			ChunkRenderer::DrawVisible();
+			return;
+		}
 
-			if (shouldCull) {
-				if (it->second) {
-					delete it->second;
+		RectBounds<int> view = CalculateChunksInView();
+		size_t viewArea = size_t(view.top - view.bottom + 1) * size_t(view.right - view.left + 1);
+		auto draw = [](Entity *chunk) {
+			if (chunk) chunk->GetComponent<ChunkRenderer>()->Render();
+		};
+
+		if (viewArea > chunks.size()) {
+			for (const auto &[chunkCoord, chunk] : chunks) {
+				if (chunkCoord.x >= view.left && chunkCoord.x <= view.right && chunkCoord.y >= view.bottom &&
+					chunkCoord.y <= view.top) {
+					draw(chunk);
+				}
+			}
+		} else {
+			for (int y = view.bottom; y <= view.top; y++) {
+				for (int x = view.left; x <= view.right; x++) {
+					if (Entity *const *chunk = chunks.Find(glm::ivec2(x, y))) {
+						draw(*chunk);
+					}
 				}
-				it = chunks.erase(it);
-			} else {
-				++it;
 			}
 		}
+		ChunkRenderer::DrawQueued();
+	}
 
-		// Also cull pending chunks that are too far away
-		for (auto it = pendingChunks.begin(); it != pendingChunks.end();) {
-			glm::ivec2 chunkCoord = *it;
+	void EvictChunks() {
+		if (isDestroying || !evictionCheckNeeded) return;
+		evictionCheckNeeded = false;
 
-			bool shouldCull = chunkCoord.x < chunkCoords.left - cullBuffer ||
-							  chunkCoord.x >= chunkCoords.right + cullBuffer ||
-							  chunkCoord.y < chunkCoords.bottom - cullBuffer ||
-							  chunkCoord.y >= chunkCoords.top + cullBuffer;
+		for (const auto &chunkCoord : residency.SelectEvictions(streamer.GetKeepRect(), GetCameraChunkCoord(), frame)) {
+			auto it = chunks.find(chunkCoord);
+			if (it == chunks.end()) continue;
 
-			if (shouldCull) {
-				generator->CancelChunk(chunkCoord);
-				it = pendingChunks.erase(it);
-			} else {
-				++it;
+			world.RemoveChunk(chunkCoord);
+			if (it->second) {
+				residency.Store(chunkCoord, *it->second->GetComponent<Chunk>()->tiles);
+				it->second->Destroy();
 			}
+			residency.OnRemoved(chunkCoord);
+			chunks.erase(it);
 		}
 	}
 
 	RectBounds<int> CalculateChunksInView() {
 		// Add null checks for safety
-		if (!Simplex::view.Camera) return {0, 0, 0, 0};
+		if (!Simplex::view.GetCamera()) return {0, 0, 0, 0};
 		
-		Camera* camera = Simplex::view.Camera->GetComponent<Camera>();
+		Camera* camera = Simplex::view.GetCamera()->GetComponent<Camera>();
 		if (!camera) return {0, 0, 0, 0};
 		
 		RectBounds<float> cameraBounds = camera->GetCameraBounds();
@@ -534,9 +673,9 @@ private:
 
 	glm::ivec2 GetCameraChunkCoord() {
 		// Add null checks for safety
-		if (!Simplex::view.Camera) return {0, 0};
+		if (!Simplex::view.GetCamera()) return {0, 0};
 		
-		Camera* camera = Simplex::view.Camera->GetComponent<Camera>();
+		Camera* camera = Simplex::view.GetCamera()->GetComponent<Camera>();
 		if (!camera) return {0, 0};
 		
 		RectBounds<float> cameraBounds = camera->GetCameraBounds();
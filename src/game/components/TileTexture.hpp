@@ -6,8 +6,8 @@
 
 struct TileTexture : IComponent {
 	std::string texture = "";
-	TileTexture() {};
-	TileTexture(std::string texture) : texture(texture) {};
+	TileTexture() { Sleep(); };
+	TileTexture(std::string texture) : texture(texture) { Sleep(); };
 };
 
 #endif
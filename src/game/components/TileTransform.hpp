@@ -9,8 +9,8 @@ struct TileTransform : IComponent {
 	glm::ivec3 position = glm::ivec3(0, 0, 0);
 	glm::ivec2 size = glm::ivec2(1, 1);
 
-	TileTransform() {};
-	TileTransform(glm::ivec3 position) : position(position) {};
+	TileTransform() { Sleep(); };
+	TileTransform(glm::ivec3 position) : position(position) { Sleep(); };
 };
 
 #endif
@@ -0,0 +1,301 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "Chunk.hpp"
+#include "ChunkTiles.hpp"
+#include "ChunkTransform.hpp"
+#include "../../engine/utils/ChunkMap.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <glm/common.hpp>
+#include <glm/ext/vector_int2.hpp>
+
+class World;
+
+// A tile visited by a rect iteration
+struct TileRef {
+	glm::ivec2 position;
+	Chunk *chunk;
+	int index;
+
+	TILE_TYPE Type() const { return chunk->tiles->GetType(index); }
+};
+
+// Walks the loaded tiles of a half-open world rect chunk by chunk: chunk rows
+// bottom to top, chunks left to right, and each chunk's part of the rect in
+// its own row-major order. Unloaded chunks are skipped. Stepping to the next
+// chunk in a row follows neighbour links instead of hashing.
+class TileRectIterator {
+  public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = TileRef;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const TileRef *;
+	using reference = const TileRef &;
+
+	TileRectIterator() = default;
+	TileRectIterator(const World *world, glm::ivec2 min, glm::ivec2 max);
+
+	reference operator*() const { return current; }
+	pointer operator->() const { return &current; }
+
+	TileRectIterator &operator++() {
+		if (++local.x < localMax.x) {
+			Update();
+			return *this;
+		}
+		local.x = localMin.x;
+		if (++local.y < localMax.y) {
+			Update();
+			return *this;
+		}
+		NextChunk(current.chunk);
+		return *this;
+	}
+
+	TileRectIterator operator++(int) {
+		TileRectIterator previous = *this;
+		++*this;
+		return previous;
+	}
+
+	bool operator==(const TileRectIterator &other) const {
+		if (done || other.done) return done == other.done;
+		return current.position == other.current.position;
+	}
+	bool operator!=(const TileRectIterator &other) const { return !(*this == other); }
+
+  private:
+	const World *world = nullptr;
+	glm::ivec2 min = glm::ivec2(0), max = glm::ivec2(0);
+	glm::ivec2 chunkMin = glm::ivec2(0), chunkMax = glm::ivec2(0);
+	glm::ivec2 chunkCoord = glm::ivec2(0);
+	glm::ivec2 local = glm::ivec2(0), localMin = glm::ivec2(0), localMax = glm::ivec2(0);
+	TileRef current = {glm::ivec2(0), nullptr, 0};
+	bool done = true;
+
+	void Update() {
+		current.position = chunkCoord * CHUNK_SIZE + local;
+		current.index = ChunkTiles::Index(local.x, local.y);
+	}
+
+	// Move to the next loaded chunk after the current one, or finish
+	void NextChunk(Chunk *previous);
+	bool EnterChunk(Chunk *chunk);
+};
+
+struct TileRect {
+	TileRectIterator first;
+
+	TileRectIterator begin() const { return first; }
+	TileRectIterator end() const { return TileRectIterator(); }
+};
+
+// The loaded tiles as they were when the snapshot was taken. Holds a shared
+// version of every chunk's tiles, so taking one copies no tile data and later
+// edits copy only the chunks they touch. Safe to read from any thread.
+class WorldSnapshot {
+  public:
+	// nullptr if the chunk wasn't loaded
+	const ChunkTiles *GetChunk(const glm::ivec2 &chunkCoord) const {
+		const std::shared_ptr<const ChunkTiles> *tiles = chunks.Find(chunkCoord);
+		return tiles ? tiles->get() : nullptr;
+	}
+
+	// TILE_EMPTY if the chunk wasn't loaded
+	TILE_TYPE GetTile(const glm::ivec2 &tile) const;
+
+	// Call fn(chunkCoord, tiles) for every chunk
+	template <typename Fn>
+	void ForEachChunk(Fn fn) const {
+		for (const auto &[chunkCoord, tiles] : chunks) {
+			fn(chunkCoord, *tiles);
+		}
+	}
+
+	size_t GetChunkCount() const { return chunks.size(); }
+
+  private:
+	friend class World;
+	ChunkMap<std::shared_ptr<const ChunkTiles>> chunks;
+};
+
+// Tile-level access to the loaded chunks. Chunks are registered as they
+// become resident and linked to their loaded neighbours, so stencils and
+// rect walks cross chunk borders by pointer. Main thread only.
+class World {
+  public:
+	static int FloorDiv(int value) {
+		return (value >= 0 ? value : value - CHUNK_SIZE + 1) / CHUNK_SIZE;
+	}
+	static glm::ivec2 ChunkCoord(glm::ivec2 tile) { return glm::ivec2(FloorDiv(tile.x), FloorDiv(tile.y)); }
+	static glm::ivec2 LocalCoord(glm::ivec2 tile) { return tile - ChunkCoord(tile) * CHUNK_SIZE; }
+
+	void AddChunk(const glm::ivec2 &chunkCoord, Chunk *chunk) {
+		RemoveChunk(chunkCoord);
+		chunks[chunkCoord] = chunk;
+
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				if (dx == 0 && dy == 0) continue;
+				Chunk *neighbour = GetChunk(chunkCoord + glm::ivec2(dx, dy));
+				chunk->neighbours[(dy + 1) * 3 + (dx + 1)] = neighbour;
+				if (neighbour) {
+					neighbour->neighbours[(1 - dy) * 3 + (1 - dx)] = chunk;
+				}
+			}
+		}
+	}
+
+	void RemoveChunk(const glm::ivec2 &chunkCoord) {
+		auto it = chunks.find(chunkCoord);
+		if (it == chunks.end()) return;
+
+		Chunk *chunk = it->second;
+		for (int slot = 0; slot < 9; slot++) {
+			if (slot == 4 || !chunk->neighbours[slot]) continue;
+			chunk->neighbours[slot]->neighbours[8 - slot] = nullptr;
+			chunk->neighbours[slot] = nullptr;
+		}
+		chunks.erase(it);
+		if (lastChunk == chunk) {
+			lastChunk = nullptr;
+		}
+	}
+
+	void Clear() {
+		for (auto &[coord, chunk] : chunks) {
+			for (int slot = 0; slot < 9; slot++) {
+				if (slot != 4) chunk->neighbours[slot] = nullptr;
+			}
+		}
+		chunks.clear();
+		lastChunk = nullptr;
+	}
+
+	Chunk *GetChunk(const glm::ivec2 &chunkCoord) const {
+		// Queries tend to stay in one chunk; skip the hash when they do
+		if (lastChunk && lastCoord == chunkCoord) return lastChunk;
+
+		Chunk *const *chunk = chunks.Find(chunkCoord);
+		if (!chunk) return nullptr;
+		lastCoord = chunkCoord;
+		lastChunk = *chunk;
+		return lastChunk;
+	}
+
+	// TILE_EMPTY if the chunk isn't loaded
+	TILE_TYPE GetTile(const glm::ivec2 &tile) const {
+		Chunk *chunk = GetChunk(ChunkCoord(tile));
+		if (!chunk) return TILE_EMPTY;
+		glm::ivec2 local = LocalCoord(tile);
+		return chunk->tiles->GetType(local.x, local.y);
+	}
+
+	// Returns false if the chunk isn't loaded
+	bool SetTile(const glm::ivec2 &tile, TILE_TYPE type) {
+		glm::ivec2 chunkCoord = ChunkCoord(tile);
+		Chunk *chunk = GetChunk(chunkCoord);
+		if (!chunk) return false;
+
+		glm::ivec2 local = LocalCoord(tile);
+		TILE_TYPE previous = chunk->tiles->GetType(local.x, local.y);
+		if (previous != type) {
+			chunk->tiles.Write().SetType(local.x, local.y, type);
+			chunk->summary.OnTileChanged(tile, previous, type);
+			chunk->changedTiles.set(ChunkTiles::Index(local.x, local.y));
+			if (chunk->entity) {
+				DefaultRegistry().MarkChanged<Chunk *>(chunk->entity->ID);
+			}
+		}
+		return true;
+	}
+
+	// Tile at a local position of a chunk that may lie up to one chunk
+	// outside it, following neighbour links. TILE_EMPTY if not loaded.
+	static TILE_TYPE GetTileNear(const Chunk &chunk, glm::ivec2 local) {
+		int dx = local.x < 0 ? -1 : (local.x >= CHUNK_SIZE ? 1 : 0);
+		int dy = local.y < 0 ? -1 : (local.y >= CHUNK_SIZE ? 1 : 0);
+		const Chunk *target = chunk.Neighbour(dx, dy);
+		if (!target) return TILE_EMPTY;
+		return target->tiles->GetType(local.x - dx * CHUNK_SIZE, local.y - dy * CHUNK_SIZE);
+	}
+
+	// Loaded tiles in [min, max)
+	TileRect Tiles(glm::ivec2 min, glm::ivec2 max) const {
+		return {TileRectIterator(this, min, max)};
+	}
+
+	// Consistent view of every loaded chunk for readers off the main thread
+	WorldSnapshot Snapshot() const {
+		WorldSnapshot snapshot;
+		snapshot.chunks.reserve(chunks.size());
+		for (const auto &[chunkCoord, chunk] : chunks) {
+			snapshot.chunks.insert(chunkCoord, chunk->tiles.Snapshot());
+		}
+		return snapshot;
+	}
+
+	size_t GetChunkCount() const { return chunks.size(); }
+
+  private:
+	ChunkMap<Chunk *> chunks;
+
+	mutable glm::ivec2 lastCoord = glm::ivec2(0);
+	mutable Chunk *lastChunk = nullptr;
+};
+
+inline TILE_TYPE WorldSnapshot::GetTile(const glm::ivec2 &tile) const {
+	const ChunkTiles *tiles = GetChunk(World::ChunkCoord(tile));
+	if (!tiles) return TILE_EMPTY;
+	glm::ivec2 local = World::LocalCoord(tile);
+	return tiles->GetType(local.x, local.y);
+}
+
+inline TileRectIterator::TileRectIterator(const World *world, glm::ivec2 min, glm::ivec2 max)
+	: world(world), min(min), max(max) {
+	if (min.x >= max.x || min.y >= max.y) return;
+
+	chunkMin = World::ChunkCoord(min);
+	chunkMax = World::ChunkCoord(max - glm::ivec2(1));
+	chunkCoord = glm::ivec2(chunkMin.x - 1, chunkMin.y);
+	done = false;
+	NextChunk(nullptr);
+}
+
+inline void TileRectIterator::NextChunk(Chunk *previous) {
+	while (true) {
+		if (++chunkCoord.x > chunkMax.x) {
+			chunkCoord.x = chunkMin.x;
+			previous = nullptr;
+			if (++chunkCoord.y > chunkMax.y) {
+				done = true;
+				current.chunk = nullptr;
+				return;
+			}
+		}
+
+		// Neighbour links are kept for every loaded chunk, so a null east
+		// link means the next chunk isn't loaded either
+		Chunk *chunk = previous ? previous->Neighbour(1, 0) : world->GetChunk(chunkCoord);
+		if (EnterChunk(chunk)) return;
+		previous = chunk;
+	}
+}
+
+inline bool TileRectIterator::EnterChunk(Chunk *chunk) {
+	if (!chunk) return false;
+
+	glm::ivec2 origin = chunkCoord * CHUNK_SIZE;
+	localMin = glm::max(min - origin, glm::ivec2(0));
+	localMax = glm::min(max - origin, glm::ivec2(CHUNK_SIZE));
+	local = localMin;
+	current.chunk = chunk;
+	Update();
+	return true;
+}
+
+#endif
@@ -7,7 +7,7 @@
 
 struct ChunkEntity : Entity {
 	ChunkEntity(glm::ivec2 position) {
-		COMPONENT(ChunkRenderer(new ChunkModel));
+		COMPONENT(ChunkRenderer(new ChunkModel(ChunkRenderer::Batch())));
 		COMPONENT(ChunkTransform(position));
 		COMPONENT(Chunk(GetComponent<ChunkRenderer>(), GetComponent<ChunkTransform>()));
 	};
@@ -1,5 +1,7 @@
 #include "../../engine/Scene.hpp"
 #include "../../engine/ecs/components/Camera.hpp"
+#include "../../engine/ecs/components/Renderer.hpp"
+#include "../components/Building.hpp"
 //#include "../components/Map.hpp"
 #include "../components/ThreadedMapGenerator.hpp"
 #include "../../engine/Userinterface.hpp"
@@ -7,7 +9,12 @@
 
 struct MainScene : public Scene {
 	MainScene() {
-		ENTITY(map, new ThreadedMap);
+		ThreadedMap *threadedMap = new ThreadedMap;
+		ENTITY(map, threadedMap);
+		threadedMap->AddSystems(systems);
+		Buildings::AddSystems(Simplex::simulation);
+		// Simulated sprites, drawn over the map
+		ENTITY(sprites, new Renderer);
 		ENTITY(cameraEntity, new Transform, new Camera);
         UI* testUi = testUserinterface();
 	}